@@ -26,6 +26,7 @@
 #include <fstream>
 #include <intervalxt/length.hpp>
 #include <iostream>
+#include <optional>
 
 #include "flatsurf/ccw.hpp"
 #include "flatsurf/flat_triangulation.hpp"
@@ -33,6 +34,7 @@
 #include "flatsurf/orientation.hpp"
 #include "flatsurf/saddle_connection.hpp"
 #include "flatsurf/saddle_connections.hpp"
+#include "flatsurf/saddle_connections_in_direction.hpp"
 #include "flatsurf/vector.hpp"
 #include "flatsurf/vector_along_triangulation.hpp"
 
@@ -51,6 +53,7 @@ using flatsurf::Bound;
 using flatsurf::FlatTriangulation;
 using flatsurf::HalfEdge;
 using flatsurf::SaddleConnections;
+using flatsurf::SaddleConnectionsInDirection;
 using flatsurf::Vector;
 using std::cout;
 using std::endl;
@@ -610,6 +613,9 @@ int main(int argc, char **argv) {
     SaddleConf sc;
 
     using SaddleConnections = SaddleConnections<FlatTriangulation>;
+    using SaddleConnectionsInDirection = SaddleConnectionsInDirection<FlatTriangulation>;
+    std::optional<SaddleConnectionsInDirection> parallel;
+
     for (auto saddle_connection : SaddleConnections(flat_triangulation, static_cast<long long>(ceil(depth * depth)))) {
       if (!Vertex::from(flatsurf::Vertex::source(saddle_connection->source(), *flat_triangulation)).relevant()) {
         // It would be good to have a proper notion of marked vertices
@@ -622,49 +628,32 @@ int main(int argc, char **argv) {
 
       auto direction = static_cast<typename FlatTriangulation::Vector>(saddle_connection->vector());
 
-      for (const HalfEdge e : flat_triangulation->halfEdges()) {
-        if (flat_triangulation->fromEdge(e).ccw(direction) == flatsurf::CCW::CLOCKWISE) {
-          continue;
-        }
-        if (flat_triangulation->fromEdge(flat_triangulation->nextAtVertex(e)).ccw(direction) == flatsurf::CCW::COUNTERCLOCKWISE) {
-          continue;
-        }
-        if (flat_triangulation->fromEdge(flat_triangulation->nextAtVertex(e)).orientation(direction) != flatsurf::ORIENTATION::SAME) {
-          continue;
-        }
+      // All the queries in the same direction share their precomputation.
+      parallel = parallel ? parallel->inDirection(direction) : SaddleConnectionsInDirection(flat_triangulation, direction, Bound(static_cast<long long>(ceil(follow_depth * follow_depth))));
+
+      for (const auto &saddle_connection_in_same_direction : *parallel) {
+        const HalfEdge e = saddle_connection_in_same_direction.source();
 
         const Vertex &source = Vertex::from(flatsurf::Vertex::source(e, *flat_triangulation));
         if (!source.relevant()) continue;
         if (source.deleted()) continue;
 
-        auto saddle_connections_in_same_direction = SaddleConnections(flat_triangulation, Bound(static_cast<long long>(ceil(follow_depth * follow_depth))), e);
-        for (auto it = saddle_connections_in_same_direction.begin();
-             it != saddle_connections_in_same_direction.end(); ++it) {
-          auto saddle_connection_in_same_direction = *it;
-
-          const Vertex &target = Vertex::from(flatsurf::Vertex::target(
-              saddle_connection_in_same_direction->target(),
-              *flat_triangulation));
-
-          if (!target.relevant()) continue;
-          if (target.deleted()) continue;
-
-          auto ccw = saddle_connection_in_same_direction->vector().ccw(saddle_connection->vector());
-          if (ccw == flatsurf::CCW::COLLINEAR) {
-            auto vector = static_cast<Vector<exactreal::Element<exactreal::NumberField>>>(saddle_connection_in_same_direction->vector());
-            assert(flat_triangulation->fromEdge(e).ccw(vector) == flatsurf::CCW::COUNTERCLOCKWISE);
-            auto dvector = static_cast<Point>(static_cast<Vector<Arb>>(vector));
-            auto start = Dir(e, dvector);
-            assert(start.v->id() == source.id());
-            // end points back to start from the target vertex
-            auto end = Dir(flat_triangulation->nextInFace(saddle_connection_in_same_direction->target()), -dvector);
-            assert(end.v->id() == target.id());
-            sc.add_saddle(start, end, vector);
-            break;
-          } else {
-            it.skipSector(-ccw);
-          }
-        }
+        const Vertex &target = Vertex::from(flatsurf::Vertex::target(
+            saddle_connection_in_same_direction.target(),
+            *flat_triangulation));
+
+        if (!target.relevant()) continue;
+        if (target.deleted()) continue;
+
+        auto vector = static_cast<Vector<exactreal::Element<exactreal::NumberField>>>(saddle_connection_in_same_direction.vector());
+        assert(flat_triangulation->fromEdge(e).ccw(vector) == flatsurf::CCW::COUNTERCLOCKWISE);
+        auto dvector = static_cast<Point>(static_cast<Vector<Arb>>(vector));
+        auto start = Dir(e, dvector);
+        assert(start.v->id() == source.id());
+        // end points back to start from the target vertex
+        auto end = Dir(flat_triangulation->nextInFace(saddle_connection_in_same_direction.target()), -dvector);
+        assert(end.v->id() == target.id());
+        sc.add_saddle(start, end, vector);
       }
       if (show_lengths || show_cyls) {
         sc.renorm_lengths();
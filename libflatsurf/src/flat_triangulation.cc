@@ -17,14 +17,21 @@
  *  along with flatsurf. If not, see <https://www.gnu.org/licenses/>.
  *********************************************************************/
 
+#include <atomic>
+#include <cassert>
+#include <exact-real/arb.hpp>
+#include <mutex>
+#include <optional>
 #include <ostream>
 #include <vector>
 
 #include "flatsurf/flat_triangulation.hpp"
 #include "flatsurf/half_edge.hpp"
 #include "flatsurf/half_edge_map.hpp"
+#include "flatsurf/permutation.hpp"
 #include "flatsurf/vector.hpp"
 #include "util/assert.ipp"
+#include "util/checked_arithmetic.ipp"
 
 using std::map;
 using std::ostream;
@@ -38,6 +45,16 @@ void updateAfterFlip(HalfEdgeMap<T> &map, HalfEdge halfEdge,
   map.set(halfEdge, map.get(-parent.nextInFace(halfEdge)) +
                         map.get(parent.nextAtVertex(halfEdge)));
 }
+
+// Return whether a·b = c·d. (For long long coordinates, the scalar products
+// might not fit into a long long, so we compare them without computing them.)
+template <typename Vector>
+bool sameScalarProduct(const Vector &a, const Vector &b, const Vector &c, const Vector &d) {
+  if constexpr (std::is_same_v<Vector, flatsurf::Vector<long long>>)
+    return checked::sgn(a.x(), b.x(), a.y(), b.y(), c.x(), d.x(), c.y(), d.y()) == 0;
+  else
+    return a * b == c * d;
+}
 }  // namespace
 
 template <typename T>
@@ -46,6 +63,17 @@ class FlatTriangulation<T>::Implementation {
   Implementation(HalfEdgeMap<Vector> &&vectors) : vectors(std::move(vectors)) {}
 
   const HalfEdgeMap<Vector> vectors;
+
+  // Approximations of vectors, see fromEdgeApproximate(). Built on first
+  // use, possibly by several threads at once.
+  mutable std::once_flag approximated;
+  mutable std::optional<HalfEdgeMap<flatsurf::Vector<exactreal::Arb>>> approximations;
+  // The half edges whose approximation is out of date because they have
+  // been flipped. (Summing the approximations of the other edges of a
+  // triangle would let the balls grow with every flip.)
+  mutable std::vector<HalfEdge> stale;
+  mutable std::atomic<bool> hasStale{false};
+  mutable std::mutex staleLock;
 };
 
 template <typename T>
@@ -53,6 +81,31 @@ const Vector<T> &FlatTriangulation<T>::fromEdge(const HalfEdge e) const {
   return impl->vectors.get(e);
 }
 
+template <typename T>
+const Vector<exactreal::Arb> &FlatTriangulation<T>::fromEdgeApproximate(const HalfEdge e) const {
+  std::call_once(impl->approximated, [&]() {
+    vector<flatsurf::Vector<exactreal::Arb>> approximations;
+    for (int edge = 1; edge <= static_cast<int>(halfEdges().size() / 2); edge++)
+      approximations.push_back(static_cast<flatsurf::Vector<exactreal::Arb>>(fromEdge(HalfEdge(edge))));
+    // When an edge is flipped, its exact vector might not have been updated
+    // yet, so we only note that its approximation needs to be recomputed.
+    impl->approximations.emplace(this, approximations, [&self = *impl](auto &, HalfEdge halfEdge, const auto &) {
+      self.stale.push_back(halfEdge);
+      self.hasStale = true;
+    });
+  });
+
+  if (impl->hasStale.load(std::memory_order_acquire)) {
+    std::lock_guard<std::mutex> lock(impl->staleLock);
+    for (auto halfEdge : impl->stale)
+      impl->approximations->set(halfEdge, static_cast<flatsurf::Vector<exactreal::Arb>>(fromEdge(halfEdge)));
+    impl->stale.clear();
+    impl->hasStale.store(false, std::memory_order_release);
+  }
+
+  return impl->approximations->get(e);
+}
+
 template <typename T>
 FlatTriangulation<T>::FlatTriangulation() noexcept : FlatTriangulation(FlatTriangulationCombinatorial(), vector<Vector>{}) {}
 
@@ -80,6 +133,76 @@ FlatTriangulation<T>::FlatTriangulation(FlatTriangulationCombinatorial &&combina
   }
 }
 
+template <typename T>
+vector<Permutation<HalfEdge>> FlatTriangulation<T>::automorphisms() const {
+  if (halfEdges().empty())
+    return {Permutation<HalfEdge>()};
+
+  vector<Permutation<HalfEdge>> automorphisms;
+
+  // Since the surface is connected, an automorphism is determined by the
+  // image of a single half edge.
+  const HalfEdge origin = halfEdges()[0];
+  const Vector &u = fromEdge(origin);
+  const Vector uu = u.perpendicular();
+
+  for (auto image : halfEdges()) {
+    const Vector &v = fromEdge(image);
+    if (!sameScalarProduct(v, v, u, u))
+      continue;
+    const Vector vv = v.perpendicular();
+
+    // Propagate origin -> image across faces and edges.
+    vector<std::optional<HalfEdge>> automorphism(halfEdges().size());
+    vector<bool> covered(halfEdges().size());
+    automorphism[HalfEdgeMap<int>::index(origin)] = image;
+    covered[HalfEdgeMap<int>::index(image)] = true;
+    vector<HalfEdge> pending{origin};
+    bool consistent = true;
+    while (consistent && !pending.empty()) {
+      const HalfEdge e = pending.back();
+      pending.pop_back();
+      const HalfEdge f = *automorphism[HalfEdgeMap<int>::index(e)];
+
+      for (const auto &[preimage, target] : {std::pair{nextInFace(e), nextInFace(f)}, std::pair{-e, -f}}) {
+        auto &mapped = automorphism[HalfEdgeMap<int>::index(preimage)];
+        if (mapped) {
+          consistent = *mapped == target;
+        } else if (covered[HalfEdgeMap<int>::index(target)]) {
+          consistent = false;
+        } else {
+          mapped = target;
+          covered[HalfEdgeMap<int>::index(target)] = true;
+          pending.push_back(preimage);
+        }
+        if (!consistent) break;
+      }
+    }
+    if (!consistent)
+      continue;
+
+    // The rotation that takes u to v takes every vector w to the vector
+    // that has the same scalar products with v and its perpendicular as w
+    // has with u and its perpendicular.
+    vector<std::pair<HalfEdge, HalfEdge>> permutation;
+    for (auto e : halfEdges()) {
+      assert(automorphism[HalfEdgeMap<int>::index(e)] && "surface must be connected");
+      const HalfEdge f = *automorphism[HalfEdgeMap<int>::index(e)];
+      if (!sameScalarProduct(fromEdge(e), u, fromEdge(f), v) || !sameScalarProduct(fromEdge(e), uu, fromEdge(f), vv)) {
+        consistent = false;
+        break;
+      }
+      permutation.emplace_back(e, f);
+    }
+    if (!consistent)
+      continue;
+
+    automorphisms.emplace_back(permutation);
+  }
+
+  return automorphisms;
+}
+
 template <typename T>
 FlatTriangulation<T>::FlatTriangulation(FlatTriangulation<T> &&rhs) noexcept : FlatTriangulation() {
   *this = std::move(rhs);
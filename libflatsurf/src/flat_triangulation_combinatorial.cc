@@ -19,6 +19,7 @@
 
 #include <boost/range/adaptors.hpp>
 #include <cstdint>
+#include <mutex>
 #include <ostream>
 #include <unordered_map>
 #include <vector>
@@ -71,6 +72,9 @@ class FlatTriangulationCombinatorial::Implementation {
   Permutation<HalfEdge> faces;
   vector<Vertex> vertexes;
   mutable unordered_map<uintptr_t, HalfEdgeMapProxy> halfEdgeMaps;
+  // Maps are created and destroyed on a const triangulation, e.g., during
+  // parallel saddle connection searches, so registration must be thread-safe.
+  mutable std::mutex halfEdgeMapsLock;
 };
 
 HalfEdge FlatTriangulationCombinatorial::nextInFace(const HalfEdge e) const {
@@ -158,6 +162,7 @@ void FlatTriangulationCombinatorial::flip(HalfEdge e) {
 template <typename T>
 void FlatTriangulationCombinatorial::registerMap(
     const HalfEdgeMap<T>& map) const {
+  std::lock_guard<std::mutex> lock(impl->halfEdgeMapsLock);
   impl->halfEdgeMaps[reinterpret_cast<uintptr_t>(&map)] = HalfEdgeMapProxy{
       std::bind(
           [](const HalfEdgeMap<T>& self, HalfEdge halfEdge,
@@ -176,6 +181,7 @@ void FlatTriangulationCombinatorial::registerMap(
 template <typename T>
 void FlatTriangulationCombinatorial::deregisterMap(const HalfEdgeMap<T>& map) const {
   uintptr_t key = reinterpret_cast<uintptr_t>(&map);
+  std::lock_guard<std::mutex> lock(impl->halfEdgeMapsLock);
   ASSERT_ARGUMENT(impl->halfEdgeMaps.find(key) != impl->halfEdgeMaps.end(), "map to deregister not found among registered maps");
   impl->halfEdgeMaps.erase(key);
 }
@@ -194,6 +200,7 @@ using namespace flatsurf;
 
 // Instantiations of templates so implementations are generated for the linker
 #include <e-antic/renfxx.h>
+#include <exact-real/arb.hpp>
 #include <exact-real/element.hpp>
 #include <exact-real/integer_ring.hpp>
 #include <exact-real/number_field.hpp>
@@ -202,6 +209,7 @@ using namespace flatsurf;
 template void flatsurf::FlatTriangulationCombinatorial::registerMap(const HalfEdgeMap<int>&) const;
 template void flatsurf::FlatTriangulationCombinatorial::registerMap(const HalfEdgeMap<long long>&) const;
 template void flatsurf::FlatTriangulationCombinatorial::registerMap(const HalfEdgeMap<mpz_class>&) const;
+template void flatsurf::FlatTriangulationCombinatorial::registerMap(const HalfEdgeMap<Vector<exactreal::Arb>>&) const;
 template void flatsurf::FlatTriangulationCombinatorial::registerMap(const HalfEdgeMap<Vector<long long>>&) const;
 template void flatsurf::FlatTriangulationCombinatorial::registerMap(const HalfEdgeMap<Vector<eantic::renf_elem_class>>&) const;
 template void flatsurf::FlatTriangulationCombinatorial::registerMap(const HalfEdgeMap<Vector<exactreal::Element<exactreal::IntegerRing>>>&) const;
@@ -210,6 +218,7 @@ template void flatsurf::FlatTriangulationCombinatorial::registerMap(const HalfEd
 template void flatsurf::FlatTriangulationCombinatorial::deregisterMap(const HalfEdgeMap<int>&) const;
 template void flatsurf::FlatTriangulationCombinatorial::deregisterMap(const HalfEdgeMap<long long>&) const;
 template void flatsurf::FlatTriangulationCombinatorial::deregisterMap(const HalfEdgeMap<mpz_class>&) const;
+template void flatsurf::FlatTriangulationCombinatorial::deregisterMap(const HalfEdgeMap<Vector<exactreal::Arb>>&) const;
 template void flatsurf::FlatTriangulationCombinatorial::deregisterMap(const HalfEdgeMap<Vector<long long>>&) const;
 template void flatsurf::FlatTriangulationCombinatorial::deregisterMap(const HalfEdgeMap<Vector<eantic::renf_elem_class>>&) const;
 template void flatsurf::FlatTriangulationCombinatorial::deregisterMap(const HalfEdgeMap<Vector<exactreal::Element<exactreal::IntegerRing>>>&) const;
@@ -85,13 +85,17 @@ void FlatTriangulationCombinatorial::save(Archive& archive) const {
   for (auto& e : halfEdges()) {
     faces.push_back(std::pair(e, nextInFace(e)));
   }
-  archive(cereal::make_nvp("faces", Permutation<HalfEdge>(vertices)));
+  archive(cereal::make_nvp("faces", Permutation<HalfEdge>(faces)));
 }
 
 template <typename Archive>
 void FlatTriangulationCombinatorial::load(Archive& archive) {
   Permutation<HalfEdge> vertices;
   archive(cereal::make_nvp("vertices", vertices));
+  // The faces are determined by the vertices but we need to consume them for
+  // archives that are not organized by name.
+  Permutation<HalfEdge> faces;
+  archive(cereal::make_nvp("faces", faces));
   *this = FlatTriangulationCombinatorial(vertices);
 }
 
@@ -112,15 +116,14 @@ template <typename Archive>
 void FlatTriangulation<T>::load(Archive& archive) {
   FlatTriangulationCombinatorial combinatorial;
   archive(cereal::make_nvp("combinatorial", combinatorial));
-  std::cout << combinatorial << std::endl;
   std::map<HalfEdge, typename FlatTriangulation<T>::Vector> map;
   archive(cereal::make_nvp("vectors", map));
 
-  auto vectors = HalfEdgeMap<typename flatsurf::FlatTriangulation<T>::Vector>(&combinatorial, [](auto&, auto, auto&) {});
-  for (auto& v : map)
-    vectors.set(v.first, v.second);
+  std::vector<typename FlatTriangulation<T>::Vector> vectors;
+  for (int e = 1; e <= static_cast<int>(combinatorial.halfEdges().size() / 2); e++)
+    vectors.push_back(map.at(HalfEdge(e)));
 
-  *this = FlatTriangulation<long long>(std::move(std::move(combinatorial)), std::move(vectors));
+  *this = FlatTriangulation<T>(std::move(combinatorial), vectors);
 }
 
 template <typename T>
@@ -159,8 +162,68 @@ void SaddleConnection<Surface>::load(Archive& archive) {
   archive(cereal::make_nvp("target", target));
   typename SaddleConnection<Surface>::Vector vector;
   archive(cereal::make_nvp("vector", vector));
+  std::vector<HalfEdge> crossings;
+  archive(cereal::make_nvp("crossings", crossings));
 
-  *this = SaddleConnection<Surface>(surface, source, target, vector);
+  *this = SaddleConnection<Surface>(surface, source, target, vector, crossings);
+}
+
+template <typename Surface>
+template <typename Archive>
+void SaddleConnections<Surface>::Sink::save(Archive& archive) const {
+  archive(cereal::make_nvp("surface", surface));
+  archive(cereal::make_nvp("source", source));
+  archive(cereal::make_nvp("target", target));
+  archive(cereal::make_nvp("x", x));
+  archive(cereal::make_nvp("y", y));
+}
+
+template <typename Surface>
+template <typename Archive>
+void SaddleConnections<Surface>::Sink::load(Archive& archive) {
+  std::shared_ptr<Surface> surface;
+  archive(cereal::make_nvp("surface", surface));
+  this->surface = surface;
+  archive(cereal::make_nvp("source", source));
+  archive(cereal::make_nvp("target", target));
+  archive(cereal::make_nvp("x", x));
+  archive(cereal::make_nvp("y", y));
+}
+
+template <typename Surface>
+template <typename Archive>
+void SaddleConnections<Surface>::Iterator::save(Archive& archive) const {
+  const auto checkpoint = this->checkpoint();
+  archive(cereal::make_nvp("surface", checkpoint.surface));
+  archive(cereal::make_nvp("searchRadius", checkpoint.searchRadius));
+  archive(cereal::make_nvp("sectors", checkpoint.sectors));
+  archive(cereal::make_nvp("window", checkpoint.window));
+  archive(cereal::make_nvp("crossings", checkpoint.crossings));
+  archive(cereal::make_nvp("automorphisms", checkpoint.automorphisms));
+  archive(cereal::make_nvp("sector", checkpoint.sector));
+  archive(cereal::make_nvp("image", checkpoint.image));
+  archive(cereal::make_nvp("stack", checkpoint.stack));
+  archive(cereal::make_nvp("log", checkpoint.log));
+}
+
+template <typename Surface>
+template <typename Archive>
+void SaddleConnections<Surface>::Iterator::load(Archive& archive) {
+  Checkpoint checkpoint;
+  std::shared_ptr<Surface> surface;
+  archive(cereal::make_nvp("surface", surface));
+  checkpoint.surface = surface;
+  archive(cereal::make_nvp("searchRadius", checkpoint.searchRadius));
+  archive(cereal::make_nvp("sectors", checkpoint.sectors));
+  archive(cereal::make_nvp("window", checkpoint.window));
+  archive(cereal::make_nvp("crossings", checkpoint.crossings));
+  archive(cereal::make_nvp("automorphisms", checkpoint.automorphisms));
+  archive(cereal::make_nvp("sector", checkpoint.sector));
+  archive(cereal::make_nvp("image", checkpoint.image));
+  archive(cereal::make_nvp("stack", checkpoint.stack));
+  archive(cereal::make_nvp("log", checkpoint.log));
+
+  restore(std::move(checkpoint));
 }
 
 }  // namespace flatsurf
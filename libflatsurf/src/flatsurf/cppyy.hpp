@@ -32,8 +32,13 @@
 #include "flatsurf/flat_triangulation.hpp"
 #include "flatsurf/half_edge_map.hpp"
 #include "flatsurf/interval_exchange_transformation.hpp"
+#include "flatsurf/precision.hpp"
 #include "flatsurf/saddle_connection.hpp"
 #include "flatsurf/saddle_connections.hpp"
+#include "flatsurf/saddle_connections_by_direction.hpp"
+#include "flatsurf/saddle_connections_by_length.hpp"
+#include "flatsurf/saddle_connections_in_direction.hpp"
+#include "flatsurf/shortest_saddle_connections.hpp"
 #include "flatsurf/vector.hpp"
 #include "flatsurf/vector_along_triangulation.hpp"
 
@@ -0,0 +1,77 @@
+/**********************************************************************
+ *  This file is part of flatsurf.
+ *
+ *        Copyright (C) 2019 Julian Rüth
+ *
+ *  Flatsurf is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, either version 3 of the License, or
+ *  (at your option) any later version.
+ *
+ *  Flatsurf is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with flatsurf. If not, see <https://www.gnu.org/licenses/>.
+ *********************************************************************/
+
+#ifndef LIBFLATSURF_DETAIL_INLINE_IMPL_HPP
+#define LIBFLATSURF_DETAIL_INLINE_IMPL_HPP
+
+#include <cstddef>
+#include <new>
+#include <utility>
+
+namespace flatsurf::detail {
+// A drop-in replacement for spimpl::impl_ptr<Implementation> that keeps the
+// Implementation inside of the object that holds it instead of allocating it
+// on the heap. Like with impl_ptr, the Implementation can be an incomplete
+// type where this is declared; however, all the special members of the
+// class holding it must then be defined where the Implementation is
+// complete. Size and Alignment must be large enough to hold an
+// Implementation which is checked when it is constructed.
+template <typename Implementation, std::size_t Size, std::size_t Alignment>
+class InlineImpl {
+ public:
+  template <typename... Args>
+  explicit InlineImpl(std::in_place_t, Args &&... args) {
+    static_assert(sizeof(Implementation) <= Size, "Implementation does not fit into the inline storage.");
+    static_assert(Alignment % alignof(Implementation) == 0, "Implementation is not sufficiently aligned in the inline storage.");
+    new (&storage) Implementation(std::forward<Args>(args)...);
+  }
+
+  InlineImpl(const InlineImpl &rhs) : InlineImpl(std::in_place, *rhs) {}
+  InlineImpl(InlineImpl &&rhs) noexcept : InlineImpl(std::in_place, std::move(*rhs)) {}
+
+  ~InlineImpl() { get()->~Implementation(); }
+
+  InlineImpl &operator=(const InlineImpl &rhs) {
+    *get() = *rhs;
+    return *this;
+  }
+
+  InlineImpl &operator=(InlineImpl &&rhs) noexcept {
+    *get() = std::move(*rhs);
+    return *this;
+  }
+
+  Implementation *operator->() noexcept { return get(); }
+  const Implementation *operator->() const noexcept { return get(); }
+  Implementation &operator*() noexcept { return *get(); }
+  const Implementation &operator*() const noexcept { return *get(); }
+
+  // Unlike an impl_ptr, this never holds nothing, not even when it has
+  // been moved from.
+  explicit operator bool() const noexcept { return true; }
+
+ private:
+  Implementation *get() noexcept { return std::launder(reinterpret_cast<Implementation *>(&storage)); }
+  const Implementation *get() const noexcept { return std::launder(reinterpret_cast<const Implementation *>(&storage)); }
+
+  alignas(Alignment) unsigned char storage[Size];
+};
+}  // namespace flatsurf::detail
+
+#endif
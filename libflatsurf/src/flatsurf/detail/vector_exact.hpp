@@ -37,8 +37,9 @@ class VectorExact : public VectorBase<Vector>,
   ORIENTATION orientation(const Vector &) const noexcept;
   bool insideCircumcircle(std::initializer_list<Vector>) const noexcept;
 
-  // Return the scalar product with the argument
-  T operator*(const Vector &)const noexcept;
+  // Return the scalar product with the argument. (For long long coordinates,
+  // this throws if the scalar product does not fit into a long long.)
+  T operator*(const Vector &) const;
 
   bool operator>(const Bound) const noexcept;
   bool operator<(const Bound) const noexcept;
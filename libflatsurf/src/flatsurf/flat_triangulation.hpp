@@ -25,6 +25,7 @@
 #include <memory>
 #include <vector>
 
+#include <exact-real/forward.hpp>
 #include "external/spimpl/spimpl.h"
 
 #include "flatsurf/flat_triangulation_combinatorial.hpp"
@@ -51,6 +52,21 @@ class FlatTriangulation : public FlatTriangulationCombinatorial {
 
   const Vector &fromEdge(HalfEdge) const;
 
+  // Return a ball approximation of fromEdge(), i.e., the same as
+  // static_cast<Vector<exactreal::Arb>>(fromEdge(e)). The approximations of
+  // all the half edges are computed when this is first called. The
+  // approximations of edges that have been flipped since are recomputed on
+  // the next call.
+  const flatsurf::Vector<exactreal::Arb> &fromEdgeApproximate(HalfEdge) const;
+
+  // Return the automorphisms of this triangulation that rotate the surface,
+  // i.e., the permutations of the half edges that preserve the combinatorial
+  // structure and under which the vectors of all the half edges turn by the
+  // same angle. The first automorphism is the identity. Note that this only
+  // finds the symmetries of the surface that are also symmetries of its
+  // triangulation.
+  std::vector<Permutation<HalfEdge>> automorphisms() const;
+
   FlatTriangulation<T> &operator=(FlatTriangulation<T> &&) noexcept;
 
   bool operator==(const FlatTriangulation<T> &) const noexcept;
@@ -53,6 +53,18 @@ class SaddleConnections;
 template <typename Surface>
 class SaddleConnection;
 
+template <typename Surface>
+class SaddleConnectionsByLength;
+
+template <typename Surface>
+class SaddleConnectionsByDirection;
+
+template <typename Surface>
+class SaddleConnectionsInDirection;
+
+template <typename Surface>
+class ShortestSaddleConnections;
+
 class HalfEdge;
 
 class Edge;
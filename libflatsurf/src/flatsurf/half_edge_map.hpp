@@ -51,8 +51,10 @@ class HalfEdgeMap final : boost::equality_comparable<HalfEdgeMap<T>> {
   template <typename S>
   friend std::ostream &operator<<(std::ostream &, const HalfEdgeMap<S> &);
 
-  HalfEdgeMap &operator=(const HalfEdgeMap &) = delete;
-  HalfEdgeMap &operator=(HalfEdgeMap &&) = delete;
+  // Assignment reuses the storage of this map and keeps its registration
+  // with the parent if the parent does not change.
+  HalfEdgeMap &operator=(const HalfEdgeMap &);
+  HalfEdgeMap &operator=(HalfEdgeMap &&);
   HalfEdgeMap operator-() const noexcept;
 
   static size_t index(const HalfEdge);
@@ -68,7 +70,7 @@ class HalfEdgeMap final : boost::equality_comparable<HalfEdgeMap<T>> {
   mutable const FlatTriangulationCombinatorial *parent;
 
   mutable std::vector<T> values;
-  const FlipHandler updateAfterFlip;
+  FlipHandler updateAfterFlip;
 };
 }  // namespace flatsurf
 
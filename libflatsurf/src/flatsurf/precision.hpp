@@ -0,0 +1,53 @@
+/**********************************************************************
+ *  This file is part of flatsurf.
+ *
+ *        Copyright (C) 2019 Julian Rüth
+ *
+ *  Flatsurf is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, either version 3 of the License, or
+ *  (at your option) any later version.
+ *
+ *  Flatsurf is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with flatsurf. If not, see <https://www.gnu.org/licenses/>.
+ *********************************************************************/
+
+#ifndef LIBFLATSURF_PRECISION_HPP
+#define LIBFLATSURF_PRECISION_HPP
+
+#include <cstddef>
+#include <optional>
+#include <vector>
+
+#include "flatsurf/flatsurf.hpp"
+
+namespace flatsurf {
+// When the predicates on vectors, such as Vector::ccw(), cannot be decided
+// with ball arithmetic at exactreal::ARB_PRECISION_FAST, they retry with
+// twice the precision until the precision exceeds maximumPrecision(). Only
+// then do they fall back to exact arithmetic.
+
+// Return the precision in bits up to which predicates are decided with ball
+// arithmetic before falling back to exact arithmetic; 256 by default.
+long maximumPrecision() noexcept;
+
+// Set the precision in bits up to which predicates are decided with ball
+// arithmetic. A value of exactreal::ARB_PRECISION_FAST or less goes straight
+// from the initial ball arithmetic to exact arithmetic. This setting is
+// shared by all threads.
+void maximumPrecision(long bits) noexcept;
+
+// Return how many predicates have been decided at each level, i.e., the i-th
+// entry counts the predicates decided at precision ARB_PRECISION_FAST·2^i
+// and the last entry counts the predicates that needed exact arithmetic.
+// Returns nothing if the library has not been configured with
+// --enable-statistics.
+std::optional<std::vector<std::size_t>> precisionStatistics();
+}  // namespace flatsurf
+
+#endif
@@ -21,6 +21,7 @@
 #define LIBFLATSURF_SADDLE_CONNECTION_HPP
 
 #include <boost/operators.hpp>
+#include <functional>
 #include <iosfwd>
 #include <optional>
 #include <vector>
@@ -35,6 +36,12 @@ class SaddleConnection : boost::equality_comparable<SaddleConnection<Surface>> {
   using Vector = typename Surface::Vector;
 
  public:
+  // The holonomy of this saddle connection. For saddle connections reported
+  // by a search, this is only computed when it is first asked for, since
+  // summing up the exact vectors of the half edges crossed can be costly.
+  // Since it is computed from the half edges of the surface as they are at
+  // that time, the surface must not be modified, e.g., by flipping edges
+  // through a non-const reference, before vector() has been called once.
   const Vector &vector() const;
   // The saddle connection is leaving from the vertex at the source of source.
   // It is leaving in a direction that is contained in the sector next to
@@ -61,8 +68,15 @@ class SaddleConnection : boost::equality_comparable<SaddleConnection<Surface>> {
 
  private:
   SaddleConnection(const std::shared_ptr<const Surface> &, HalfEdge source, HalfEdge target, const Vector &);
+  SaddleConnection(const std::shared_ptr<const Surface> &, HalfEdge source, HalfEdge target, const Vector &, const std::vector<HalfEdge> &crossings);
+  // A saddle connection whose vector is computed by the callback the first
+  // time that it is needed.
+  SaddleConnection(const std::shared_ptr<const Surface> &, HalfEdge source, HalfEdge target, std::function<Vector()> &&vector, std::optional<std::vector<HalfEdge>> &&crossings);
 
   friend SaddleConnections<Surface>;
+  friend SaddleConnectionsByLength<Surface>;
+  friend SaddleConnectionsByDirection<Surface>;
+  friend SaddleConnectionsInDirection<Surface>;
 
   friend cereal::access;
   template <typename Archive>
@@ -21,7 +21,11 @@
 #define LIBFLATSURF_SADDLE_CONNECTIONS_HPP
 
 #include <boost/iterator/iterator_facade.hpp>
+#include <cstdint>
+#include <functional>
+#include <memory>
 #include <optional>
+#include <vector>
 #include "external/spimpl/spimpl.h"
 
 #include "flatsurf/forward.hpp"
@@ -43,13 +47,29 @@ class SaddleConnections {
   // counter-clockwise order.
   SaddleConnections(const std::shared_ptr<const Surface> &, Bound searchRadius, HalfEdge sectorBegin);
 
+  // All saddle connections on the surface whose direction lies strictly
+  // between begin and end in counter-clockwise order. The angle from begin to
+  // end must be less than π. Parts of the surface that cannot contain such
+  // saddle connections are not searched at all, so this is much faster than
+  // filtering the result of a search for all directions when the window is
+  // narrow.
+  SaddleConnections(const std::shared_ptr<const Surface> &, Bound searchRadius, const typename Surface::Vector &begin, const typename Surface::Vector &end);
+
   class Iterator : public boost::iterator_facade<Iterator, const std::unique_ptr<SaddleConnection<Surface>>, std::forward_iterator_tag, const std::unique_ptr<SaddleConnection<Surface>>> {
     class Implementation;
     spimpl::impl_ptr<Implementation> impl;
 
     friend SaddleConnections;
+    friend SaddleConnectionsByLength<Surface>;
+    friend SaddleConnectionsByDirection<Surface>;
+    friend SaddleConnectionsInDirection<Surface>;
 
    public:
+    // The iterator that marks the end of every search, see end(). It compares
+    // equal to any iterator that has run to the end of its search without
+    // copying or comparing the state of that search. It cannot be advanced or
+    // dereferenced.
+    Iterator();
     Iterator(spimpl::impl_ptr<Implementation> &&impl);
 
     // Advance the iterator to the next saddle connection.
@@ -64,6 +84,36 @@ class SaddleConnections {
 
     void skipSector(CCW sector);
 
+    // Counters for the work that the search did to get to this iterator,
+    // e.g., to understand why the search is slow on some surfaces.
+    struct Statistics {
+      // The number of triangles that the search entered.
+      size_t triangles = 0;
+      // The number of times that the search brought its vectors up to date
+      // with the moves across the surface it had postponed, the number of
+      // such moves, and how many of these were combined with other moves
+      // so they did not need to be applied to the vectors individually.
+      size_t applyMoves = 0;
+      size_t moves = 0;
+      size_t collapsed = 0;
+      // The maximum number of triangles that the search was deep.
+      size_t depth = 0;
+      // The number of orientation predicates decided by floating point
+      // approximations and the ones that needed exact (or ball) arithmetic.
+      size_t approximate = 0;
+      size_t exact = 0;
+      // The number of subsectors that the search did not descend into
+      // because they are beyond the search radius.
+      size_t pruned = 0;
+    };
+
+    // Return the work that the search did to get here (including the work
+    // of the iterators this one has been copied from,) or nothing if the
+    // library has not been configured with --enable-statistics. Collecting
+    // statistics makes the search a bit slower, so it is disabled by
+    // default and costs nothing then.
+    std::optional<Statistics> statistics() const;
+
 // Detect GCC (and skip clang/cling so we do not see warnings): https://stackoverflow.com/questions/38499462/how-to-tell-clang-to-stop-pretending-to-be-other-compilers
 #if defined(__GNUC__) && !defined(__llvm__)
 #pragma GCC diagnostic push
@@ -74,17 +124,165 @@ class SaddleConnections {
 #if defined(__GNUC__) && !defined(__llvm__)
 #pragma GCC diagnostic pop
 #endif
+
+   private:
+    // The state of an iterator as plain data that cereal can serialize, see
+    // cereal.hpp. The vectors that the search keeps track of are not part of
+    // it; they are recomputed from the way the search descended into the
+    // current sector, so a checkpoint only grows with the depth of the search.
+    struct Checkpoint {
+      std::shared_ptr<const Surface> surface;
+      long long searchRadius;
+      std::vector<HalfEdge> sectors;
+      // The rays of the window of the search (if any.)
+      std::vector<typename Surface::Vector> window;
+      bool crossings;
+      // The automorphisms the search exploits (if any.)
+      std::vector<Permutation<HalfEdge>> automorphisms;
+      size_t sector;
+      size_t image;
+      // The stack of the search's state machine…
+      std::vector<std::uint8_t> stack;
+      // …or, when built with coroutines, what is needed to replay the search
+      // coroutine in the current sector.
+      std::vector<std::uint64_t> log;
+    };
+
+    Checkpoint checkpoint() const;
+    // Replace the state of this iterator with the one described by the
+    // checkpoint. Whatever the checkpoint shares with the search of this
+    // iterator (such as its surface) is taken from this search, so that the
+    // restored iterator compares equal to the iterators of this search.
+    void restore(Checkpoint &&);
+
+    // Iterators can be serialized with cereal, see cereal.hpp, e.g., to
+    // checkpoint a long running search and continue it later. Restoring an
+    // iterator takes time proportional to the depth of the search, not to the
+    // work that had been done already. (When built with coroutines, the search
+    // in the current sector needs to be replayed however.) Iterators of a
+    // search returned by grow() cannot be serialized and neither can the end()
+    // sentinel.
+    friend cereal::access;
+    template <typename Archive>
+    void save(Archive &archive) const;
+    template <typename Archive>
+    void load(Archive &archive);
   };
 
   Iterator begin() const;
+  // Return the end() sentinel, i.e., a default constructed Iterator. This is
+  // cheap, so end() can be called in the condition of a loop, and a search
+  // is a std::ranges::range in C++20.
   Iterator end() const;
 
+  // Return the saddle connections of length in (R, searchRadius] where R is
+  // the search radius of this search, i.e., the saddle connections that a
+  // search with the larger radius finds in addition to the ones found here.
+  // The returned search continues where this search stopped, so growing the
+  // radius step by step costs about as much as searching with the final
+  // radius right away. Note that only searches created by grow() keep track
+  // of where they stop, i.e., the first call to grow() runs this search once
+  // more. (The same happens if no iterator of a grown search has run to the
+  // end.)
+  SaddleConnections grow(Bound searchRadius) const;
+
+  // Return this search but such that the saddle connections it reports know
+  // which half edges they cross, see SaddleConnection::crossings(). This
+  // costs little during the search, whereas saddle connections that do not
+  // know their crossings need to search for themselves again to determine
+  // them. (A search returned by grow() can only record crossings if the
+  // search that it continues recorded them.)
+  SaddleConnections withCrossings() const;
+
+  // Return this search but such that it only searches one sector of every
+  // orbit of the automorphisms of the surface, see
+  // FlatTriangulation::automorphisms(), and reports the saddle connections in
+  // the other sectors as the images of the ones it found there. This finds
+  // the same saddle connections (in a different order) but divides the work
+  // by the number of automorphisms, e.g., count() does not compute the
+  // images at all. Only a search in all sectors without a window can do
+  // this, and its iterators cannot skipSector() or
+  // incrementWithCrossings().
+  SaddleConnections withSymmetries() const;
+
+  // Return the part of this search that the shard-th of several processes
+  // runs when this search is split between shards processes. Every saddle
+  // connection of this search is found by exactly one of the shards. The
+  // partition only depends on this search and the number of shards, so
+  // processes that do not communicate agree on it. To balance the shards, the
+  // top levels of the search tree are expanded until no subsector is expected
+  // to contain a sizable part of a shard's work, where the number of saddle
+  // connections in a subsector is estimated from the area that it covers
+  // within the search radius. A shard does not report its saddle connections
+  // in the order of this search, see merge().
+  SaddleConnections shard(size_t shard, size_t shards) const;
+
+  // Saddle connections stored as a structure of arrays, see collect().
+  struct Sink {
+    // The surface all these saddle connections live on.
+    std::shared_ptr<const Surface> surface;
+    std::vector<HalfEdge> source;
+    std::vector<HalfEdge> target;
+    // The coordinates of the saddle connection vectors.
+    std::vector<typename Surface::Vector::Coordinate> x;
+    std::vector<typename Surface::Vector::Coordinate> y;
+
+    size_t size() const noexcept { return source.size(); }
+
+    // Sinks can be serialized with cereal, see cereal.hpp, e.g., to send the
+    // saddle connections collected by a shard to the process that merges
+    // them.
+    template <typename Archive>
+    void save(Archive &archive) const;
+    template <typename Archive>
+    void load(Archive &archive);
+  };
+
+  // Append all the saddle connections of this search to the sink. Unlike the
+  // iterators, this does not create a SaddleConnection object for each saddle
+  // connection, so this only allocates when the sink's vectors need to grow.
+  void collect(Sink &) const;
+
+  // Return the saddle connections collected by the shards of a search, see
+  // shard(), in a canonical order, i.e., ordered by source, target, and
+  // coordinates, so that the result does not depend on the number of shards.
+  // The sinks must all live on the same surface. (The counts of the shards
+  // simply add up.)
+  static Sink merge(std::vector<Sink> &&sinks);
+
+  // Return the number of saddle connections of this search. Unlike
+  // std::distance(begin(), end()), this does not create a SaddleConnection
+  // object for each saddle connection.
+  size_t count() const;
+
+  // Return a histogram of the lengths of the saddle connections of this
+  // search, i.e., the number of saddle connections whose length lies in
+  // (bins[i - 1], bins[i]] for each i (where bins[-1] is zero.) Saddle
+  // connections longer than bins.back() are not counted. The bins must be
+  // increasing.
+  std::vector<size_t> count(const std::vector<Bound> &bins) const;
+
+  // Run this search on several threads and invoke the callback for every
+  // saddle connection found. The sectors are distributed among the threads,
+  // and whenever a thread runs out of work, it steals a subsector that
+  // another thread has not searched yet. The callback is invoked concurrently
+  // from all threads; its second argument is the index of the calling thread.
+  // If threads is zero, one thread per hardware thread is used.
+  // Note that saddle connections are reported in no particular order.
+  void parallel(const std::function<void(std::unique_ptr<SaddleConnection<Surface>>, size_t)> &callback, size_t threads = 0) const;
+
+  // Return all the saddle connections of this search computed on several
+  // threads (in no particular order.)
+  std::vector<std::unique_ptr<SaddleConnection<Surface>>> parallel(size_t threads = 0) const;
+
   template <typename Surf>
   friend std::ostream &operator<<(std::ostream &, const SaddleConnections<Surf> &);
 
  private:
   class Implementation;
   spimpl::impl_ptr<Implementation> impl;
+
+  SaddleConnections(spimpl::impl_ptr<Implementation> &&);
 };
 
 template <typename Surface>
@@ -96,6 +294,9 @@ SaddleConnections(const std::shared_ptr<Surface> &, Bound, const Vertex &)->Sadd
 template <typename Surface>
 SaddleConnections(const std::shared_ptr<Surface> &, Bound, const HalfEdge &)->SaddleConnections<Surface>;
 
+template <typename Surface>
+SaddleConnections(const std::shared_ptr<Surface> &, Bound, const typename Surface::Vector &, const typename Surface::Vector &)->SaddleConnections<Surface>;
+
 }  // namespace flatsurf
 
 #endif
@@ -0,0 +1,71 @@
+/**********************************************************************
+ *  This file is part of flatsurf.
+ *
+ *        Copyright (C) 2019 Julian Rüth
+ *
+ *  Flatsurf is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, either version 3 of the License, or
+ *  (at your option) any later version.
+ *
+ *  Flatsurf is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with flatsurf. If not, see <https://www.gnu.org/licenses/>.
+ *********************************************************************/
+
+#ifndef LIBFLATSURF_SADDLE_CONNECTIONS_BY_DIRECTION_HPP
+#define LIBFLATSURF_SADDLE_CONNECTIONS_BY_DIRECTION_HPP
+
+#include <boost/iterator/iterator_facade.hpp>
+#include <memory>
+#include "external/spimpl/spimpl.h"
+
+#include "flatsurf/forward.hpp"
+
+namespace flatsurf {
+// The saddle connections on a surface in counterclockwise order of their
+// direction, starting at the direction of (1, 0), merged over all the
+// vertices of the surface. In particular, saddle connections that are
+// parallel come right after each other. Like SaddleConnectionsByLength, this
+// explores the surface in the order in which the saddle connections are
+// reported, so the memory needed is proportional to the number of
+// subsectors crossing the current direction, not to the number of saddle
+// connections reported.
+template <typename Surface>
+class SaddleConnectionsByDirection {
+ public:
+  // All saddle connections on the surface of length at most searchRadius.
+  SaddleConnectionsByDirection(const std::shared_ptr<const Surface> &, Bound searchRadius);
+
+  class Iterator : public boost::iterator_facade<Iterator, const std::unique_ptr<SaddleConnection<Surface>>, std::forward_iterator_tag, const std::unique_ptr<SaddleConnection<Surface>>> {
+    class Implementation;
+    spimpl::impl_ptr<Implementation> impl;
+
+    friend SaddleConnectionsByDirection;
+
+   public:
+    Iterator(spimpl::impl_ptr<Implementation> &&impl);
+
+    void increment();
+    bool equal(const Iterator &other) const;
+    std::unique_ptr<SaddleConnection<Surface>> dereference() const;
+  };
+
+  Iterator begin() const;
+  Iterator end() const;
+
+ private:
+  class Implementation;
+  spimpl::impl_ptr<Implementation> impl;
+};
+
+template <typename Surface>
+SaddleConnectionsByDirection(const std::shared_ptr<Surface> &, Bound)->SaddleConnectionsByDirection<Surface>;
+
+}  // namespace flatsurf
+
+#endif
@@ -0,0 +1,78 @@
+/**********************************************************************
+ *  This file is part of flatsurf.
+ *
+ *        Copyright (C) 2019 Julian Rüth
+ *
+ *  Flatsurf is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, either version 3 of the License, or
+ *  (at your option) any later version.
+ *
+ *  Flatsurf is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with flatsurf. If not, see <https://www.gnu.org/licenses/>.
+ *********************************************************************/
+
+#ifndef LIBFLATSURF_SADDLE_CONNECTIONS_BY_LENGTH_HPP
+#define LIBFLATSURF_SADDLE_CONNECTIONS_BY_LENGTH_HPP
+
+#include <boost/iterator/iterator_facade.hpp>
+#include <memory>
+#include "external/spimpl/spimpl.h"
+
+#include "flatsurf/forward.hpp"
+
+namespace flatsurf {
+// The saddle connections on a surface in order of increasing length. Unlike
+// SaddleConnections, which reports the saddle connections in the order in
+// which its depth-first search finds them, this explores the surface
+// best-first, i.e., it always continues in the part of the surface that is
+// closest to the vertex it starts from, and reports a saddle connection as
+// soon as none of the parts it has not explored yet can contain a shorter
+// one. So the memory needed is proportional to the boundary of the explored
+// region, not to the number of saddle connections reported.
+template <typename Surface>
+class SaddleConnectionsByLength {
+ public:
+  // All saddle connections on the surface. Note that there are infinitely
+  // many, so the iterators never reach end().
+  SaddleConnectionsByLength(const std::shared_ptr<const Surface> &);
+
+  // All saddle connections on the surface of length at most searchRadius.
+  SaddleConnectionsByLength(const std::shared_ptr<const Surface> &, Bound searchRadius);
+
+  class Iterator : public boost::iterator_facade<Iterator, const std::unique_ptr<SaddleConnection<Surface>>, std::forward_iterator_tag, const std::unique_ptr<SaddleConnection<Surface>>> {
+    class Implementation;
+    spimpl::impl_ptr<Implementation> impl;
+
+    friend SaddleConnectionsByLength;
+
+   public:
+    Iterator(spimpl::impl_ptr<Implementation> &&impl);
+
+    void increment();
+    bool equal(const Iterator &other) const;
+    std::unique_ptr<SaddleConnection<Surface>> dereference() const;
+  };
+
+  Iterator begin() const;
+  Iterator end() const;
+
+ private:
+  class Implementation;
+  spimpl::impl_ptr<Implementation> impl;
+};
+
+template <typename Surface>
+SaddleConnectionsByLength(const std::shared_ptr<Surface> &)->SaddleConnectionsByLength<Surface>;
+
+template <typename Surface>
+SaddleConnectionsByLength(const std::shared_ptr<Surface> &, Bound)->SaddleConnectionsByLength<Surface>;
+
+}  // namespace flatsurf
+
+#endif
@@ -0,0 +1,69 @@
+/**********************************************************************
+ *  This file is part of flatsurf.
+ *
+ *        Copyright (C) 2019 Julian Rüth
+ *
+ *  Flatsurf is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, either version 3 of the License, or
+ *  (at your option) any later version.
+ *
+ *  Flatsurf is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with flatsurf. If not, see <https://www.gnu.org/licenses/>.
+ *********************************************************************/
+#ifndef LIBFLATSURF_SADDLE_CONNECTIONS_IN_DIRECTION_HPP
+#define LIBFLATSURF_SADDLE_CONNECTIONS_IN_DIRECTION_HPP
+
+#include <memory>
+#include <vector>
+#include "external/spimpl/spimpl.h"
+
+#include "flatsurf/forward.hpp"
+#include "flatsurf/saddle_connection.hpp"
+
+namespace flatsurf {
+// The saddle connections on a surface that point in a fixed direction.
+// Unlike a search with SaddleConnections, this does not explore the sectors
+// containing that direction but walks along the direction straight across
+// the surface until it hits a vertex, so it only visits the triangles that
+// the saddle connections cross.
+template <typename Surface>
+class SaddleConnectionsInDirection {
+ public:
+  // All saddle connections on the surface of length at most searchRadius
+  // that are positive multiples of direction.
+  SaddleConnectionsInDirection(const std::shared_ptr<const Surface> &, const typename Surface::Vector &direction, Bound searchRadius);
+
+  using Iterator = typename std::vector<SaddleConnection<Surface>>::const_iterator;
+
+  // The saddle connections ordered by the half edge they start next to, see
+  // SaddleConnection::source(). There is at most one for each half edge.
+  Iterator begin() const;
+  Iterator end() const;
+
+  size_t size() const;
+
+  // Return the saddle connections in another direction with the same search
+  // radius. The data about the surface that this query needs is shared with
+  // this one, so querying many directions one after another only costs the
+  // walks themselves.
+  SaddleConnectionsInDirection inDirection(const typename Surface::Vector &direction) const;
+
+ private:
+  class Implementation;
+  spimpl::impl_ptr<Implementation> impl;
+
+  SaddleConnectionsInDirection(spimpl::impl_ptr<Implementation> &&);
+};
+
+template <typename Surface>
+SaddleConnectionsInDirection(const std::shared_ptr<Surface> &, const typename Surface::Vector &, Bound)->SaddleConnectionsInDirection<Surface>;
+
+}  // namespace flatsurf
+
+#endif
@@ -0,0 +1,62 @@
+/**********************************************************************
+ *  This file is part of flatsurf.
+ *
+ *        Copyright (C) 2019 Julian Rüth
+ *
+ *  Flatsurf is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, either version 3 of the License, or
+ *  (at your option) any later version.
+ *
+ *  Flatsurf is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with flatsurf. If not, see <https://www.gnu.org/licenses/>.
+ *********************************************************************/
+
+#ifndef LIBFLATSURF_SHORTEST_SADDLE_CONNECTIONS_HPP
+#define LIBFLATSURF_SHORTEST_SADDLE_CONNECTIONS_HPP
+
+#include <memory>
+#include <vector>
+#include "external/spimpl/spimpl.h"
+
+#include "flatsurf/forward.hpp"
+#include "flatsurf/saddle_connection.hpp"
+
+namespace flatsurf {
+// The k shortest saddle connections on a surface. Unlike SaddleConnections,
+// this does not need to know a search radius beforehand: the search explores
+// the surface best-first, i.e., it always continues in the part of the
+// surface that is closest to the vertex it starts from, and stops as soon as
+// none of the parts it has not explored can contain a saddle connection
+// shorter than the k shortest ones found so far.
+template <typename Surface>
+class ShortestSaddleConnections {
+ public:
+  ShortestSaddleConnections(const std::shared_ptr<const Surface> &, size_t k);
+
+  using Iterator = typename std::vector<SaddleConnection<Surface>>::const_iterator;
+
+  // The saddle connections in order of increasing length. If there are
+  // several saddle connections as long as the longest one reported here, only
+  // some of them might be reported.
+  Iterator begin() const;
+  Iterator end() const;
+
+  size_t size() const;
+
+ private:
+  class Implementation;
+  spimpl::impl_ptr<Implementation> impl;
+};
+
+template <typename Surface>
+ShortestSaddleConnections(const std::shared_ptr<Surface> &, size_t)->ShortestSaddleConnections<Surface>;
+
+}  // namespace flatsurf
+
+#endif
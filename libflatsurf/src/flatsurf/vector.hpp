@@ -22,6 +22,7 @@
 #include <exact-real/forward.hpp>
 #include "external/spimpl/spimpl.h"
 
+#include "flatsurf/detail/inline_impl.hpp"
 #include "flatsurf/detail/vector_exact.hpp"
 #include "flatsurf/detail/vector_with_error.hpp"
 #include "flatsurf/forward.hpp"
@@ -35,6 +36,13 @@ class Vector : public std::conditional_t<std::is_same_v<T, exactreal::Arb>, deta
 
   Vector();
   Vector(const Coordinate& x, const Coordinate& y);
+  Vector(const Vector&);
+  Vector(Vector&&) noexcept;
+  ~Vector();
+
+  // Assignment overwrites the coordinates of this vector in place.
+  Vector& operator=(const Vector&);
+  Vector& operator=(Vector&&) noexcept;
 
   Coordinate x() const noexcept;
   Coordinate y() const noexcept;
@@ -53,7 +61,14 @@ class Vector : public std::conditional_t<std::is_same_v<T, exactreal::Arb>, deta
   void load(Archive& archive);
 
   class Implementation;
-  spimpl::impl_ptr<Implementation> impl;
+  // Vectors with long long or Arb coordinates keep their coordinates inline
+  // so that arithmetic with them does not allocate. All other coordinate
+  // types live on the heap. (The sizes reserved here are checked when the
+  // Implementation is constructed. An Arb consists of six words.)
+  using Storage = std::conditional_t<std::is_same_v<T, long long>, detail::InlineImpl<Implementation, 2 * sizeof(long long), alignof(long long)>,
+                                     std::conditional_t<std::is_same_v<T, exactreal::Arb>, detail::InlineImpl<Implementation, 2 * 6 * sizeof(void*), alignof(void*)>,
+                                                        spimpl::impl_ptr<Implementation>>>;
+  Storage impl;
 };
 }  // namespace flatsurf
 
@@ -20,6 +20,7 @@
 #define LIBFLATSURF_VECTOR_ALONG_TRIANGULATION_HPP
 
 #include <boost/operators.hpp>
+#include <utility>
 #include <vector>
 #include "external/spimpl/spimpl.h"
 
@@ -43,6 +44,13 @@ class VectorAlongTriangulation : public std::conditional_t<std::is_base_of_v<det
   explicit VectorAlongTriangulation(const std::shared_ptr<const Surface> &);
   VectorAlongTriangulation(const std::shared_ptr<const Surface> &, const std::vector<HalfEdge> &);
   VectorAlongTriangulation(const std::shared_ptr<const Surface> &, const HalfEdgeMap<int> &coefficients);
+  VectorAlongTriangulation(const VectorAlongTriangulation &);
+  VectorAlongTriangulation(VectorAlongTriangulation &&) noexcept;
+
+  // Assignment overwrites this vector in place, i.e., it does not allocate
+  // when both vectors live on the same surface.
+  VectorAlongTriangulation &operator=(const VectorAlongTriangulation &);
+  VectorAlongTriangulation &operator=(VectorAlongTriangulation &&) noexcept;
 
   VectorAlongTriangulation &operator+=(const HalfEdge);
   VectorAlongTriangulation &operator-=(const HalfEdge);
@@ -53,6 +61,11 @@ class VectorAlongTriangulation : public std::conditional_t<std::is_base_of_v<det
 
   operator Vector<T>() const noexcept;
 
+  // Return the half edges that this vector is the sum of together with their
+  // multiplicities. Only vectors that keep track of an approximation also
+  // keep track of these coefficients; otherwise this throws.
+  std::vector<std::pair<HalfEdge, int>> coefficients() const;
+
  private:
   friend detail::VectorBase<VectorAlongTriangulation<T, Approximation>>;
   friend detail::VectorExact<VectorAlongTriangulation<T, Approximation>, T>;
@@ -73,6 +73,38 @@ HalfEdgeMap<T>::HalfEdgeMap(HalfEdgeMap &&rhs)
   }
 }
 
+template <typename T>
+HalfEdgeMap<T> &HalfEdgeMap<T>::operator=(const HalfEdgeMap &rhs) {
+  if (parent != rhs.parent) {
+    if (parent != nullptr) {
+      parent->deregisterMap(*this);
+    }
+    parent = rhs.parent;
+    if (parent != nullptr) {
+      parent->registerMap(*this);
+    }
+  }
+  values = rhs.values;
+  updateAfterFlip = rhs.updateAfterFlip;
+  return *this;
+}
+
+template <typename T>
+HalfEdgeMap<T> &HalfEdgeMap<T>::operator=(HalfEdgeMap &&rhs) {
+  if (parent != rhs.parent) {
+    if (parent != nullptr) {
+      parent->deregisterMap(*this);
+    }
+    parent = rhs.parent;
+    if (parent != nullptr) {
+      parent->registerMap(*this);
+    }
+  }
+  values = std::move(rhs.values);
+  updateAfterFlip = rhs.updateAfterFlip;
+  return *this;
+}
+
 template <typename T>
 HalfEdgeMap<T>::~HalfEdgeMap() {
   // When the parent gets destructed, it sets the parent pointer in every
@@ -138,6 +170,7 @@ ostream &operator<<(ostream &os, const flatsurf::HalfEdgeMap<T> &self) {
 }  // namespace flatsurf
 
 // Instantiations of templates so implementations are generated for the linker
+#include <exact-real/arb.hpp>
 #include <exact-real/element.hpp>
 #include <exact-real/integer_ring.hpp>
 #include <exact-real/number_field.hpp>
@@ -146,6 +179,8 @@ ostream &operator<<(ostream &os, const flatsurf::HalfEdgeMap<T> &self) {
 
 using namespace flatsurf;
 
+template class flatsurf::HalfEdgeMap<Vector<exactreal::Arb>>;
+template ostream &flatsurf::operator<<(ostream &, const HalfEdgeMap<Vector<exactreal::Arb>> &);
 template class flatsurf::HalfEdgeMap<Vector<long long>>;
 template ostream &flatsurf::operator<<(ostream &, const HalfEdgeMap<Vector<long long>> &);
 template class flatsurf::HalfEdgeMap<Vector<eantic::renf_elem_class>>;
@@ -18,7 +18,6 @@
  *********************************************************************/
 
 #include <gmpxx.h>
-#include <boost/lexical_cast.hpp>
 #include <exact-real/yap/arb.hpp>
 #include <optional>
 
@@ -30,8 +29,8 @@
 #include "flatsurf/vector_along_triangulation.hpp"
 
 #include "util/assert.ipp"
+#include "util/checked_arithmetic.ipp"
 
-using boost::lexical_cast;
 using exactreal::Arb;
 using exactreal::ARB_PRECISION_FAST;
 using std::optional;
@@ -61,7 +60,7 @@ class LengthAlongTriangulation<T>::Implementation {
 
   Implementation(const std::shared_ptr<const Surface>& parent, Vector<T> const* horizontal, const HalfEdge e) : parent(parent), horizontal(horizontal), coefficients(HalfEdgeMap<Coefficient>(this->parent.get(), updateAfterFlip)), approximation() {
     coefficients->set(e, 1);
-    approximation = static_cast<Vector<Arb>>(parent->fromEdge(e)) * static_cast<Vector<Arb>>(*horizontal);
+    approximation = parent->fromEdgeApproximate(e) * static_cast<Vector<Arb>>(*horizontal);
 
     ASSERT_ARGUMENT(static_cast<T>(*this) >= 0, "Lenghts must not be negative");
   }
@@ -76,7 +75,7 @@ class LengthAlongTriangulation<T>::Implementation {
 
     // Update approximation from the latest exact value
     if constexpr (std::is_same_v<T, long long>) {
-      approximation = Arb(mpz_class(lexical_cast<std::string>(ret)));
+      approximation = checked::arb(ret);
     } else if constexpr (std::is_same_v<T, eantic::renf_elem_class>) {
       approximation = Arb(ret, ARB_PRECISION_FAST);
     } else {
@@ -172,8 +171,10 @@ LengthAlongTriangulation<T>& LengthAlongTriangulation<T>::operator*=(const Quoti
   if (impl->coefficients) {
     impl->coefficients->apply([&](const HalfEdge e, const typename Implementation::Coefficient& c) {
       if constexpr (std::is_same_v<long long, T>) {
-        ASSERT_ARGUMENT(rhs * mpz_class(lexical_cast<std::string>(c)) <= mpz_class(lexical_cast<std::string>(LONG_LONG_MAX)), "Multiplication overflow");
-        impl->coefficients->set(e, c * lexical_cast<long long>(lexical_cast<std::string>(rhs)));
+        CHECK_ARGUMENT(checked::fits(rhs), "Multiplication overflow");
+        const auto product = checked::product(c, checked::toLongLong(rhs));
+        CHECK_ARGUMENT(product, "Multiplication overflow");
+        impl->coefficients->set(e, *product);
       } else {
         impl->coefficients->set(e, c * rhs);
       }
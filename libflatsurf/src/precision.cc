@@ -0,0 +1,76 @@
+/**********************************************************************
+ *  This file is part of flatsurf.
+ *
+ *        Copyright (C) 2019 Julian Rüth
+ *
+ *  Flatsurf is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, either version 3 of the License, or
+ *  (at your option) any later version.
+ *
+ *  Flatsurf is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with flatsurf. If not, see <https://www.gnu.org/licenses/>.
+ *********************************************************************/
+
+#include <algorithm>
+#include <array>
+#include <atomic>
+#include <mutex>
+
+#include "flatsurf/config.h"
+#include "flatsurf/precision.hpp"
+
+#include "vector/adaptive.ipp"
+
+namespace flatsurf {
+namespace {
+// Precisions beyond the last level are never tried, see adaptive::decide().
+constexpr long PRECISION_LIMIT = exactreal::ARB_PRECISION_FAST << (adaptive::LEVELS - 1);
+
+std::atomic<long> precision = 256;
+
+#ifdef LIBFLATSURF_STATISTICS
+std::array<std::atomic<std::size_t>, adaptive::LEVELS + 1> counters{};
+#endif
+}  // namespace
+
+long maximumPrecision() noexcept {
+  return precision.load(std::memory_order_relaxed);
+}
+
+void maximumPrecision(long bits) noexcept {
+  precision.store(std::min(bits, PRECISION_LIMIT), std::memory_order_relaxed);
+}
+
+std::optional<std::vector<std::size_t>> precisionStatistics() {
+#ifdef LIBFLATSURF_STATISTICS
+  std::vector<std::size_t> ret;
+  for (const auto& count : counters)
+    ret.push_back(count.load(std::memory_order_relaxed));
+  return ret;
+#else
+  return {};
+#endif
+}
+
+namespace adaptive {
+std::recursive_mutex& refinement() noexcept {
+  static std::recursive_mutex lock;
+  return lock;
+}
+}  // namespace adaptive
+
+#ifdef LIBFLATSURF_STATISTICS
+namespace adaptive {
+void resolved(std::size_t level) noexcept {
+  counters[level].fetch_add(1, std::memory_order_relaxed);
+}
+}  // namespace adaptive
+#endif
+
+}  // namespace flatsurf
@@ -23,6 +23,8 @@
 #include <boost/lexical_cast.hpp>
 #include <climits>
 #include <intervalxt/length.hpp>
+#include <memory>
+#include <mutex>
 #include <ostream>
 
 #include "flatsurf/flat_triangulation.hpp"
@@ -38,13 +40,33 @@ namespace flatsurf {
 template <typename Surface>
 class SaddleConnection<Surface>::Implementation {
  public:
-  Implementation(const std::shared_ptr<const Surface> &surface, HalfEdge source, HalfEdge target, const typename Surface::Vector &vector)
-      : surface(surface), source(source), target(target), vector(vector) {}
+  Implementation(const std::shared_ptr<const Surface> &surface, HalfEdge source, HalfEdge target, const typename Surface::Vector &vector, std::optional<std::vector<HalfEdge>> crossings = {})
+      : surface(surface), source(source), target(target), holonomy(std::make_shared<Holonomy>()), crossings(std::move(crossings)) {
+    holonomy->vector = vector;
+  }
+
+  Implementation(const std::shared_ptr<const Surface> &surface, HalfEdge source, HalfEdge target, std::function<typename Surface::Vector()> &&vector, std::optional<std::vector<HalfEdge>> &&crossings)
+      : surface(surface), source(source), target(target), holonomy(std::make_shared<Holonomy>()), crossings(std::move(crossings)) {
+    holonomy->lazy = std::move(vector);
+  }
+
+  // The vector of a saddle connection, unless it has not been computed yet,
+  // in which case lazy computes it (exactly once, even when several threads
+  // ask for it.) Copies of a saddle connection share it, so they do not need
+  // to compute it again.
+  struct Holonomy {
+    std::once_flag computed;
+    std::optional<typename Surface::Vector> vector;
+    std::function<typename Surface::Vector()> lazy;
+  };
 
   std::shared_ptr<const Surface> surface;
   HalfEdge source;
   HalfEdge target;
-  typename Surface::Vector vector;
+  std::shared_ptr<Holonomy> holonomy;
+  // The half edges crossed by this saddle connection if they were recorded
+  // when it was found, see SaddleConnections::withCrossings().
+  std::optional<std::vector<HalfEdge>> crossings;
 };
 
 template <typename Surface, typename _>
@@ -67,6 +89,12 @@ ostream &operator<<(ostream &os, const SaddleConnection<Surface> &self) {
 template <typename Surface>
 SaddleConnection<Surface>::SaddleConnection(const std::shared_ptr<const Surface> &surface, HalfEdge source, HalfEdge target, const typename Surface::Vector &vector) : impl(spimpl::make_impl<Implementation>(surface, source, target, vector)) {}
 
+template <typename Surface>
+SaddleConnection<Surface>::SaddleConnection(const std::shared_ptr<const Surface> &surface, HalfEdge source, HalfEdge target, const typename Surface::Vector &vector, const std::vector<HalfEdge> &crossings) : impl(spimpl::make_impl<Implementation>(surface, source, target, vector, crossings)) {}
+
+template <typename Surface>
+SaddleConnection<Surface>::SaddleConnection(const std::shared_ptr<const Surface> &surface, HalfEdge source, HalfEdge target, std::function<typename Surface::Vector()> &&vector, std::optional<std::vector<HalfEdge>> &&crossings) : impl(spimpl::make_impl<Implementation>(surface, source, target, std::move(vector), std::move(crossings))) {}
+
 template <typename Surface>
 bool SaddleConnection<Surface>::operator==(const SaddleConnection<Surface> &rhs) const {
   bool ret = impl->surface == rhs.impl->surface && static_cast<typename Surface::Vector>(vector()) == static_cast<typename Surface::Vector>(rhs.vector()) && source() == rhs.source();
@@ -84,10 +112,22 @@ template <typename Surface>
 const Surface &SaddleConnection<Surface>::surface() const { return *impl->surface; }
 
 template <typename Surface>
-const typename Surface::Vector &SaddleConnection<Surface>::vector() const { return impl->vector; }
+const typename Surface::Vector &SaddleConnection<Surface>::vector() const {
+  auto &holonomy = *impl->holonomy;
+  std::call_once(holonomy.computed, [&]() {
+    if (!holonomy.vector) {
+      holonomy.vector = holonomy.lazy();
+      holonomy.lazy = nullptr;
+    }
+  });
+  return *holonomy.vector;
+}
 
 template <typename Surface>
 std::vector<HalfEdge> SaddleConnection<Surface>::crossings() const {
+  if (impl->crossings)
+    return *impl->crossings;
+
   std::vector<HalfEdge> ret;
 
   // We reconstruct the sequence of half edges that this saddle connection
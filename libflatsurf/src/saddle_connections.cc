@@ -17,411 +17,427 @@
  *  along with flatsurf. If not, see <https://www.gnu.org/licenses/>.
  *********************************************************************/
 
-#include <exact-real/arb.hpp>
-#include <intervalxt/length.hpp>
-#include <stack>
+#include <iterator>
+#include <mutex>
+#include <thread>
+#include <variant>
 
 #include "flatsurf/flat_triangulation.hpp"
 #include "flatsurf/half_edge.hpp"
+#include "flatsurf/half_edge_map.hpp"
+#include "flatsurf/permutation.hpp"
 #include "flatsurf/saddle_connection.hpp"
 #include "flatsurf/saddle_connections.hpp"
 #include "flatsurf/vector.hpp"
-#include "flatsurf/vector_along_triangulation.hpp"
-
-#include "util/assert.ipp"
-
-using std::vector;
-namespace {
-enum class Classification {
-  OUTSIDE_SEARCH_SECTOR_CLOCKWISE,
-  SADDLE_CONNECTION,
-  OUTSIDE_SEARCH_SECTOR_COUNTERCLOCKWISE,
-};
-
-enum class State {
-  START,
-  OUTSIDE_SEARCH_SECTOR_CLOCKWISE_SEARCHING,
-  OUTSIDE_SEARCH_SECTOR_COUNTERCLOCKWISE_SEARCHING,
-  SADDLE_CONNECTION_FOUND,
-  SADDLE_CONNECTION_FOUND_SEARCHING_FIRST,
-  SADDLE_CONNECTION_FOUND_SEARCHING_SECOND,
-  END,
-};
-
-enum class Move {
-  GOTO_OTHER_FACE,
-  GOTO_NEXT_EDGE,
-  GOTO_PREVIOUS_EDGE,
-};
-}  // namespace
+
+#include "saddle_connections/iterator.ipp"
+#include "util/work_stealing_pool.ipp"
 
 namespace flatsurf {
 template <typename Surface>
-class SaddleConnections<Surface>::Implementation {
- public:
-  Implementation(Iterator&& begin) noexcept : begin(std::move(begin)) {}
+SaddleConnections<Surface>::SaddleConnections(const std::shared_ptr<const Surface>& surface, const Bound searchRadius)
+    : impl(spimpl::make_impl<Implementation>(spimpl::make_impl<typename Iterator::Implementation>(surface, searchRadius, surface->halfEdges()))) {}
+
+template <typename Surface>
+SaddleConnections<Surface>::SaddleConnections(const std::shared_ptr<const Surface>& surface, const Bound searchRadius, const Vertex source)
+    : impl(spimpl::make_impl<Implementation>(spimpl::make_impl<typename Iterator::Implementation>(surface, searchRadius, surface->atVertex(source)))) {}
+
+template <typename Surface>
+SaddleConnections<Surface>::SaddleConnections(const std::shared_ptr<const Surface>& surface, const Bound searchRadius, const HalfEdge sectorBegin)
+    : impl(spimpl::make_impl<Implementation>(spimpl::make_impl<typename Iterator::Implementation>(surface, searchRadius, vector<HalfEdge>{sectorBegin}))) {}
 
-  Iterator begin;
-};
+template <typename Surface>
+SaddleConnections<Surface>::SaddleConnections(const std::shared_ptr<const Surface>& surface, const Bound searchRadius, const typename Surface::Vector& begin, const typename Surface::Vector& end)
+    : impl(spimpl::make_impl<Implementation>(spimpl::make_impl<typename Iterator::Implementation>(surface, searchRadius, surface->halfEdges(), nullptr, std::make_shared<const typename Iterator::Implementation::Window>(begin, end)))) {
+  CHECK_ARGUMENT(begin.ccw(end) == CCW::COUNTERCLOCKWISE, "window must be less than π wide");
+}
 
 template <typename Surface>
-class SaddleConnections<Surface>::Iterator::Implementation {
-  using AlongTriangulation = VectorAlongTriangulation<typename Surface::Vector::Coordinate, std::conditional_t<std::is_same_v<typename Surface::Vector::Coordinate, long long>, void, exactreal::Arb>>;
+SaddleConnections<Surface>::SaddleConnections(spimpl::impl_ptr<Implementation>&& impl) : impl(std::move(impl)) {}
 
- public:
-  Implementation(const std::shared_ptr<const Surface>& surface, const Bound searchRadius, const vector<HalfEdge> searchSectors) : surface(std::move(surface)), searchRadius(searchRadius), sectors(std::move(searchSectors)), sector(0), boundary{AlongTriangulation(this->surface), AlongTriangulation(this->surface)}, nextEdgeEnd(AlongTriangulation(this->surface)) {
-    if (sectors.size()) {
-      prepareSearch(sectors[0]);
-    }
+template <typename Surface>
+typename SaddleConnections<Surface>::Iterator SaddleConnections<Surface>::begin() const {
+  return impl->begin;
+}
+
+template <typename Surface>
+typename SaddleConnections<Surface>::Iterator SaddleConnections<Surface>::end() const {
+  return Iterator();
+}
+
+template <typename Surface>
+SaddleConnections<Surface> SaddleConnections<Surface>::grow(const Bound searchRadius) const {
+  using Search = typename Iterator::Implementation;
+
+  const Search& search = *impl->begin.impl;
+
+  CHECK_ARGUMENT(!(searchRadius < search.searchRadius), "search radius must not shrink");
+
+  std::shared_ptr<const typename Search::Frontier> frontier;
+  if (search.published) {
+    std::lock_guard<std::mutex> lock(search.published->lock);
+    frontier = search.published->frontier;
   }
 
-  void prepareSearch(HalfEdge e) {
-    assert(state.size() == 0);
-    assert(tmp.size() == 0);
-    assert(moves.size() == 0);
-
-    boundary[0] = AlongTriangulation(surface, vector<HalfEdge>{e});
-    nextEdge = surface->nextInFace(e);
-    boundary[1] = boundary[0] + nextEdge;
-    nextEdgeEnd = boundary[1];
-    state.push(State::END);
-    state.push(State::START);
-
-    // Report nextEdgeEnd as a saddle connection unless it's already outside
-    // of the search radius.
-    if (nextEdgeEnd > searchRadius) {
-      while (!increment())
-        ;
-    }
+  if (frontier == nullptr) {
+    // This search does not record where it stops (which is somewhat costly)
+    // or none of our iterators has run to the end, so we run the search once
+    // more to find out where it stops.
+    auto published = std::make_shared<typename Search::Published>();
+    Search recording(search.surface, search.searchRadius, search.sectors, search.approximations, search.window, search.recordCrossings, search.lowerBound, search.previous, published, search.automorphisms);
+    while (recording.sector != recording.sectors.size())
+      recording.increment();
+    frontier = published->frontier;
   }
 
-  std::shared_ptr<const Surface> surface;
-  const Bound searchRadius;
-  const vector<HalfEdge> sectors;
-  // The half edge nextEdge, to which we are currently changing, points into
-  // sectors. Advanced when we are done searching an entire such sector for all
-  // saddle connections. (An index into sectors.)
-  size_t sector;
-
-  // The rays that enclose the search sector, in counterclockwise order. They
-  // themselves come from saddle connections, starting at the search origin and
-  // pointing to a vertex of the flat triangulation.
-  AlongTriangulation boundary[2];
-  // The half-edge that we are about to cross, seen from the search origin,
-  // i.e., oriented so that it starts on the side of boundary[0]
-  HalfEdge nextEdge;
-  // The vector to the target of nextEdge
-  AlongTriangulation nextEdgeEnd;
-
-  // The call stack for increment().
-  // As of early 2019, C++ lacks stackless coroutines. This code would be much
-  // more readable with async/await idioms. And likely faster.
-  // Unfortunately, boost's coroutines are not stackless and therefore too
-  // slow, and co2 exceeds the stack size quickly, so we have to roll our own
-  // stack for the time being.
-  // At the same time, we cannot make recursive calls inside this function,
-  // i.e., "return increment()" since that also exceeds the stack size for
-  // (much larger) radii. (Strangely, GCC, as of early 2019, does not
-  // optimize such tail recursion.)
-  std::stack<State> state;
-
-  // We collect pending moves across the surface here (adding half edges to
-  // nextEdgeEnd mostly.) When the exact value of nextEdgeEnd is required, we
-  // can often combine several move more efficiently, see applyMoves().
-  std::deque<Move> moves;
-
-  // Storage space for temporary values of boundary, when we descend
-  // recursively into a subsector.
-  std::stack<AlongTriangulation> tmp;
-
-  bool increment() {
-    assert(state.size());
-    assert(sector != sectors.size());
-    assert(boundary[0].ccw(boundary[1]) == CCW::COUNTERCLOCKWISE);
-
-    const auto s = state.top();
-    state.pop();
-    switch (s) {
-      case State::END:
-        applyMoves();
-        sector++;
-        if (sector != sectors.size()) {
-          prepareSearch(sectors[sector]);
-        }
-        return true;
-      case State::START:
-        moves.push_back(Move::GOTO_OTHER_FACE);
-        moves.push_back(Move::GOTO_NEXT_EDGE);
-
-        applyMoves();
-        switch (classifyHalfEdgeEnd()) {
-          case Classification::OUTSIDE_SEARCH_SECTOR_CLOCKWISE:
-            // Since this vertex is outside of the search sector on the
-            // clockwise side, we skip the clockwise sector in the recursive
-            // search and recurse into the counterclockwise sector.
-            moves.push_back(Move::GOTO_NEXT_EDGE);
-            // Note that the following is a nop that just exists for symmetry.
-            state.push(State::OUTSIDE_SEARCH_SECTOR_CLOCKWISE_SEARCHING);
-            state.push(State::START);
-            return false;
-          case Classification::OUTSIDE_SEARCH_SECTOR_COUNTERCLOCKWISE:
-            // Similarly, we skip the counterclockwise sector.
-            state.push(State::OUTSIDE_SEARCH_SECTOR_COUNTERCLOCKWISE_SEARCHING);
-            state.push(State::START);
-            return false;
-          case Classification::SADDLE_CONNECTION:
-            state.push(State::SADDLE_CONNECTION_FOUND);
-            if (!(nextEdgeEnd > searchRadius)) {
-              // Report this saddle connection.
-              return true;
-            } else {
-              // If the vertex is beyond the search radius, we do not report
-              // this new saddle connection. If additionaly, the other vertices
-              // of this triangle had already been outside of the search radius,
-              // we abort the search here.
-              bool baseIsAlreadyExceedingSearchRadius = true;
-              moves.push_back(Move::GOTO_NEXT_EDGE);
-              applyMoves();
-              baseIsAlreadyExceedingSearchRadius &=
-                  (nextEdgeEnd > searchRadius);
-              moves.push_back(Move::GOTO_NEXT_EDGE);
-              applyMoves();
-              baseIsAlreadyExceedingSearchRadius &=
-                  (nextEdgeEnd > searchRadius);
-              if (baseIsAlreadyExceedingSearchRadius) {
-                // The other vertices of the triangle are outside of the search
-                // radius; abort the search here, i.e., backtrack.
-                moves.push_back(Move::GOTO_OTHER_FACE);
-                state.pop();
-              } else {
-                // One of the vertices is inside the search radius; continue the
-                // search.
-                moves.push_back(Move::GOTO_NEXT_EDGE);
-              }
-              return false;
-            }
-        }
-        throw std::logic_error("impossible to happen");
-      case State::SADDLE_CONNECTION_FOUND:
-        // We have just reported a saddle connection; now we prepare
-        // the recursive descend into the clockwise sector.
-        tmp.push(boundary[1]);
-        applyMoves();
-        boundary[1] = nextEdgeEnd;
-        state.push(State::SADDLE_CONNECTION_FOUND_SEARCHING_SECOND);
-        state.push(State::START);
-        state.push(State::SADDLE_CONNECTION_FOUND_SEARCHING_FIRST);
-        state.push(State::START);
-        return false;
-      case State::SADDLE_CONNECTION_FOUND_SEARCHING_FIRST:
-        // We have just come back from the search in the clockwise sector; now
-        // we prepare the recursive descend into the counterclockwise sector.
-        boundary[1] = tmp.top();
-        tmp.pop();
-        tmp.push(boundary[0]);
-        applyMoves();
-        boundary[0] = nextEdgeEnd;
-        moves.push_back(Move::GOTO_NEXT_EDGE);
-        return false;
-      case State::SADDLE_CONNECTION_FOUND_SEARCHING_SECOND:
-        // We have just come back from the search in the counterclockwise
-        // sector; we are done here and return in the recursion.
-        boundary[0] = tmp.top();
-        tmp.pop();
-        break;
-      case State::OUTSIDE_SEARCH_SECTOR_COUNTERCLOCKWISE_SEARCHING:
-        moves.push_back(Move::GOTO_NEXT_EDGE);
-        break;
-      case State::OUTSIDE_SEARCH_SECTOR_CLOCKWISE_SEARCHING:
-        break;
-    }
+  vector<HalfEdge> sectors;
+  for (const auto& connection : frontier->connections)
+    sectors.push_back(connection.source);
+  for (const auto& subsector : frontier->subsectors)
+    sectors.push_back(subsector.sector);
 
-    moves.push_back(Move::GOTO_NEXT_EDGE);
-    moves.push_back(Move::GOTO_OTHER_FACE);
-    return false;
-  }
+  return SaddleConnections(spimpl::make_impl<Implementation>(spimpl::make_impl<Search>(search.surface, searchRadius, std::move(sectors), search.approximations, search.window, search.recordCrossings, search.searchRadius, frontier, std::make_shared<typename Search::Published>(), search.automorphisms)));
+}
 
-  void skipSector(CCW sector) {
-    ASSERT_ARGUMENT(sector != CCW::COLLINEAR,
-                    "There is no such thing like a collinear sector.");
+template <typename Surface>
+SaddleConnections<Surface> SaddleConnections<Surface>::withCrossings() const {
+  using Search = typename Iterator::Implementation;
+
+  const Search& search = *impl->begin.impl;
 
-    if (state.top() == State::SADDLE_CONNECTION_FOUND) {
-      increment();
+  return SaddleConnections(spimpl::make_impl<Implementation>(spimpl::make_impl<Search>(search.surface, search.searchRadius, search.sectors, search.approximations, search.window, true, search.lowerBound, search.previous, search.published ? std::make_shared<typename Search::Published>() : nullptr, search.automorphisms)));
+}
 
-      if (sector == CCW::CLOCKWISE) {
-        // Go directly to the second sector by skipping the recursive call,
-        // i.e., the START.
-        assert(state.top() == State::START);
-        state.pop();
+template <typename Surface>
+SaddleConnections<Surface> SaddleConnections<Surface>::withSymmetries() const {
+  using Search = typename Iterator::Implementation;
 
-        assert(state.top() == State::SADDLE_CONNECTION_FOUND_SEARCHING_FIRST);
-      } else if (sector == CCW::COUNTERCLOCKWISE) {
-        assert(state.top() == State::START);
-        state.pop();
+  const Search& search = *impl->begin.impl;
 
-        assert(state.top() == State::SADDLE_CONNECTION_FOUND_SEARCHING_FIRST);
-        state.pop();
+  if (search.automorphisms)
+    return *this;
 
-        assert(state.top() == State::START);
-        // Skip the second recursive call by dropping its START.
-        state.pop();
+  CHECK_ARGUMENT(search.sectors == search.surface->halfEdges() && search.window == nullptr && search.previous == nullptr, "only a search in all sectors of the surface can exploit its symmetries");
 
-        // And push the rest back on the stack unchanged.
-        state.push(State::SADDLE_CONNECTION_FOUND_SEARCHING_FIRST);
-        state.push(State::START);
-      }
-    } else if (state.top() == State::START && state.size() == 2) {
-      if (sector == CCW::CLOCKWISE) {
-        // We are in the initial state, the reported saddle connection is on
-        // the counterclockwise end of the search vector. If we skip the
-        // clockwise sector, then we skip everything.
-        state.pop();
-        assert(state.top() == State::END);
-      } else {
-        // We are skipping the counterclockwise sector anyway.
-        ;
-      }
-    } else {
-      throw std::logic_error(
-          "sectors can only be skipped when a saddle connection has been "
-          "reported");
-    }
-  }
+  auto automorphisms = std::make_shared<const vector<Permutation<HalfEdge>>>(search.surface->automorphisms());
 
-  void apply(const Move m) {
-    switch (m) {
-      case Move::GOTO_NEXT_EDGE:
-        nextEdge = surface->nextInFace(nextEdge);
-        nextEdgeEnd += nextEdge;
-        break;
-      case Move::GOTO_OTHER_FACE:
-        nextEdge = -nextEdge;
-        nextEdgeEnd += nextEdge;
-        break;
-      case Move::GOTO_PREVIOUS_EDGE:
-        nextEdgeEnd -= nextEdge;
-        nextEdge = surface->nextAtVertex(nextEdge);
-        nextEdge = -nextEdge;
-        break;
-    }
+  // Only an automorphism that fixes no half edge can turn the surface
+  // (except for the identity,) so all orbits have the same size and we keep
+  // one sector of each.
+  vector<bool> covered(search.sectors.size());
+  vector<HalfEdge> sectors;
+  for (auto e : search.sectors) {
+    if (covered[HalfEdgeMap<int>::index(e)])
+      continue;
+    sectors.push_back(e);
+    for (const auto& automorphism : *automorphisms)
+      covered[HalfEdgeMap<int>::index(automorphism(e))] = true;
   }
 
-  void applyMoves() {
-    if (moves.size() == 0) {
-      return;
-    }
-    while (moves.size()) {
-      const auto m = moves.front();
-      moves.pop_front();
-      if (moves.size() == 0) {
-        apply(m);
-        return;
+  return SaddleConnections(spimpl::make_impl<Implementation>(spimpl::make_impl<Search>(search.surface, search.searchRadius, std::move(sectors), search.approximations, nullptr, search.recordCrossings, std::nullopt, nullptr, search.published ? std::make_shared<typename Search::Published>() : nullptr, std::move(automorphisms))));
+}
+
+template <typename Surface>
+SaddleConnections<Surface> SaddleConnections<Surface>::shard(const size_t shard, const size_t shards) const {
+  using Search = typename Iterator::Implementation;
+  using Frontier = typename Search::Frontier;
+  using Node = typename Search::Node;
+
+  CHECK_ARGUMENT(shard < shards, "shard must be less than the number of shards");
+
+  const Search& search = *impl->begin.impl;
+
+  const auto weight = [&](const Node& node) {
+    if (const auto* subsector = std::get_if<typename Frontier::Subsector>(&node))
+      return search.weight(*subsector);
+    return 0.;
+  };
+
+  // The top of the search tree (in the order in which the search visits it)
+  // together with the estimated number of saddle connections below each node.
+  vector<std::pair<Node, double>> nodes;
+  for (auto& node : search.roots())
+    nodes.emplace_back(node, weight(node));
+
+  // Expand the subsectors that are expected to contain more than a small
+  // fraction of the work of a shard. This only takes a few levels and is
+  // cheap compared to the actual search.
+  constexpr size_t granularity = 16;
+  constexpr size_t levels = 64;
+  for (size_t level = 0; level < levels; level++) {
+    double total = 0;
+    for (const auto& node : nodes)
+      total += node.second;
+    const double threshold = total / static_cast<double>(granularity * shards);
+
+    bool expanded = false;
+    vector<std::pair<Node, double>> next;
+    for (auto& node : nodes) {
+      const auto* subsector = std::get_if<typename Frontier::Subsector>(&node.first);
+      if (subsector == nullptr || !(node.second > threshold)) {
+        next.push_back(std::move(node));
+        continue;
       }
 
-      const auto n = moves.front();
-      moves.pop_front();
-
-      switch (m) {
-        case Move::GOTO_NEXT_EDGE:
-          switch (n) {
-            case Move::GOTO_NEXT_EDGE:
-              moves.push_front(Move::GOTO_PREVIOUS_EDGE);
-              continue;
-            case Move::GOTO_PREVIOUS_EDGE:
-              continue;
-            case Move::GOTO_OTHER_FACE:
-              nextEdge = surface->nextInFace(nextEdge);
-              nextEdge = -nextEdge;
-              continue;
-          }
-        case Move::GOTO_PREVIOUS_EDGE:
-          switch (n) {
-            case Move::GOTO_NEXT_EDGE:
-              continue;
-            case Move::GOTO_PREVIOUS_EDGE:
-              moves.push_front(Move::GOTO_NEXT_EDGE);
-              continue;
-            case Move::GOTO_OTHER_FACE:
-              apply(Move::GOTO_NEXT_EDGE);
-              moves.push_front(Move::GOTO_OTHER_FACE);
-              moves.push_front(Move::GOTO_NEXT_EDGE);
-              continue;
-          }
-        case Move::GOTO_OTHER_FACE:
-          switch (n) {
-            case Move::GOTO_NEXT_EDGE:
-#pragma GCC diagnostic push
-#pragma GCC diagnostic ignored "-Wimplicit-fallthrough"
-              moves.push_front(Move::GOTO_PREVIOUS_EDGE);
-#pragma GCC diagnostic pop
-              // fallthrough to the next case intended here
-            case Move::GOTO_PREVIOUS_EDGE:
-              nextEdge = -nextEdge;
-              nextEdge = surface->nextAtVertex(nextEdge);
-              nextEdge = -nextEdge;
-              continue;
-            case Move::GOTO_OTHER_FACE:
-              continue;
-          }
+      expanded = true;
+      auto children = search.branch(*subsector);
+      if (children.empty()) {
+        // The search ends right away in this subsector.
+        next.emplace_back(std::move(node.first), 0.);
+        continue;
       }
+      for (auto& child : children)
+        next.emplace_back(child, weight(child));
     }
+    nodes = std::move(next);
+
+    if (!expanded)
+      break;
   }
 
-  Classification classifyHalfEdgeEnd() const {
-    switch (boundary[0].ccw(nextEdgeEnd)) {
-      case CCW::CLOCKWISE:
-      case CCW::COLLINEAR:
-        return Classification::OUTSIDE_SEARCH_SECTOR_CLOCKWISE;
-      case CCW::COUNTERCLOCKWISE:
-        switch (boundary[1].ccw(nextEdgeEnd)) {
-          case CCW::CLOCKWISE:
-            return Classification::SADDLE_CONNECTION;
-          case CCW::COUNTERCLOCKWISE:
-          case CCW::COLLINEAR:
-            return Classification::OUTSIDE_SEARCH_SECTOR_COUNTERCLOCKWISE;
-        }
-    }
-    throw std::logic_error("impossible to happen");
+  // Assign consecutive nodes to the shards such that their estimated work is
+  // balanced. (If there is nothing to estimate, we balance the number of
+  // nodes instead.)
+  double total = 0;
+  for (const auto& node : nodes)
+    total += node.second;
+
+  auto frontier = std::make_shared<Frontier>();
+  frontier->crossings = search.recordCrossings;
+
+  double before = 0;
+  for (const auto& node : nodes) {
+    const double work = total > 0 ? node.second : 1.;
+    const double center = (before + work / 2) / (total > 0 ? total : static_cast<double>(nodes.size()));
+    before += work;
+
+    if (std::min(shards - 1, static_cast<size_t>(center * static_cast<double>(shards))) != shard)
+      continue;
+
+    if (const auto* connection = std::get_if<typename Frontier::Connection>(&node.first))
+      frontier->connections.push_back(*connection);
+    else
+      frontier->subsectors.push_back(std::get<typename Frontier::Subsector>(node.first));
   }
 
-  friend std::ostream& operator<<(std::ostream& os, const Implementation& self) {
-    if (self.sector == self.sectors.size()) {
-      return os << "Iterator(END)";
+  // This shard continues the search in its part of the search tree like
+  // grow() continues the frontier of a search.
+  vector<HalfEdge> sectors;
+  for (const auto& connection : frontier->connections)
+    sectors.push_back(connection.source);
+  for (const auto& subsector : frontier->subsectors)
+    sectors.push_back(subsector.sector);
+
+  return SaddleConnections(spimpl::make_impl<Implementation>(spimpl::make_impl<Search>(search.surface, search.searchRadius, std::move(sectors), search.approximations, search.window, search.recordCrossings, search.lowerBound, std::move(frontier), std::make_shared<typename Search::Published>(), search.automorphisms)));
+}
+
+template <typename Surface>
+void SaddleConnections<Surface>::collect(Sink& sink) const {
+  auto search = *impl->begin.impl;
+
+  if (sink.surface == nullptr)
+    sink.surface = search.surface;
+  CHECK_ARGUMENT(sink.surface == search.surface, "sink must collect saddle connections of this surface");
+
+  // The crossings of the images of a saddle connection under the
+  // automorphisms. We reuse this buffer so we do not allocate per record.
+  vector<HalfEdge> crossings;
+
+  while (search.sector != search.sectors.size()) {
+    sink.source.push_back(search.sectors[search.sector]);
+    sink.target.push_back(search.nextEdge);
+    sink.x.push_back(search.nextEdgeEnd.x());
+    sink.y.push_back(search.nextEdgeEnd.y());
+
+    for (size_t image = 1; image < search.images(); image++) {
+      const auto& automorphism = (*search.automorphisms)[image];
+      crossings.clear();
+      for (auto crossing : search.path)
+        crossings.push_back(automorphism(crossing));
+      const auto developed = search.develop(automorphism(search.sectors[search.sector]), crossings, automorphism(search.nextEdge));
+      sink.source.push_back(automorphism(search.sectors[search.sector]));
+      sink.target.push_back(automorphism(search.nextEdge));
+      sink.x.push_back(developed.x());
+      sink.y.push_back(developed.y());
     }
-    return os << "Iterator(sector = " << self.sectors[self.sector] << ", connection = " << self.nextEdgeEnd << ")";
+
+    while (!search.increment())
+      ;
   }
-};
+}
 
 template <typename Surface>
-SaddleConnections<Surface>::SaddleConnections(const std::shared_ptr<const Surface>& surface, const Bound searchRadius)
-    : impl(spimpl::make_impl<Implementation>(spimpl::make_impl<typename Iterator::Implementation>(surface, searchRadius, surface->halfEdges()))) {}
+typename SaddleConnections<Surface>::Sink SaddleConnections<Surface>::merge(std::vector<Sink>&& sinks) {
+  Sink merged;
+
+  for (auto& sink : sinks) {
+    if (sink.surface == nullptr)
+      // Nothing has been collected in this sink.
+      continue;
+    if (merged.surface == nullptr)
+      merged.surface = sink.surface;
+    CHECK_ARGUMENT(merged.surface == sink.surface || *merged.surface == *sink.surface, "sinks must collect saddle connections of the same surface");
+
+    merged.source.insert(merged.source.end(), sink.source.begin(), sink.source.end());
+    merged.target.insert(merged.target.end(), sink.target.begin(), sink.target.end());
+    std::move(sink.x.begin(), sink.x.end(), std::back_inserter(merged.x));
+    std::move(sink.y.begin(), sink.y.end(), std::back_inserter(merged.y));
+  }
+
+  vector<size_t> order(merged.size());
+  for (size_t i = 0; i < order.size(); i++)
+    order[i] = i;
+  std::sort(order.begin(), order.end(), [&](const size_t lhs, const size_t rhs) {
+    if (merged.source[lhs] != merged.source[rhs])
+      return merged.source[lhs] < merged.source[rhs];
+    if (merged.target[lhs] != merged.target[rhs])
+      return merged.target[lhs] < merged.target[rhs];
+    if (merged.x[lhs] != merged.x[rhs])
+      return merged.x[lhs] < merged.x[rhs];
+    return merged.y[lhs] < merged.y[rhs];
+  });
+
+  Sink sorted;
+  sorted.surface = merged.surface;
+  for (auto i : order) {
+    sorted.source.push_back(merged.source[i]);
+    sorted.target.push_back(merged.target[i]);
+    sorted.x.push_back(std::move(merged.x[i]));
+    sorted.y.push_back(std::move(merged.y[i]));
+  }
+  return sorted;
+}
 
 template <typename Surface>
-SaddleConnections<Surface>::SaddleConnections(const std::shared_ptr<const Surface>& surface, const Bound searchRadius, const Vertex source)
-    : impl(spimpl::make_impl<Implementation>(spimpl::make_impl<typename Iterator::Implementation>(surface, searchRadius, surface->atVertex(source)))) {}
+size_t SaddleConnections<Surface>::count() const {
+  auto search = *impl->begin.impl;
+
+  size_t count = 0;
+  while (search.sector != search.sectors.size()) {
+    // The images of a saddle connection under automorphisms are just as
+    // long, so we do not need to compute them.
+    count += search.images();
+    while (!search.increment())
+      ;
+  }
+  return count;
+}
 
 template <typename Surface>
-SaddleConnections<Surface>::SaddleConnections(const std::shared_ptr<const Surface>& surface, const Bound searchRadius, const HalfEdge sectorBegin)
-    : impl(spimpl::make_impl<Implementation>(spimpl::make_impl<typename Iterator::Implementation>(surface, searchRadius, vector<HalfEdge>{sectorBegin}))) {}
+std::vector<size_t> SaddleConnections<Surface>::count(const std::vector<Bound>& bins) const {
+  for (size_t i = 1; i < bins.size(); i++)
+    CHECK_ARGUMENT(bins[i - 1] < bins[i], "bins must be increasing");
+
+  auto search = *impl->begin.impl;
+
+  vector<size_t> histogram(bins.size());
+  while (search.sector != search.sectors.size()) {
+    // The first bin that is not exceeded by this saddle connection.
+    const auto bin = std::partition_point(bins.begin(), bins.end(), [&](const Bound bound) { return search.nextEdgeEnd > bound; });
+    if (bin != bins.end())
+      histogram[bin - bins.begin()] += search.images();
+
+    while (!search.increment())
+      ;
+  }
+  return histogram;
+}
 
 template <typename Surface>
-typename SaddleConnections<Surface>::Iterator SaddleConnections<Surface>::begin() const {
-  return impl->begin;
+void SaddleConnections<Surface>::parallel(const std::function<void(std::unique_ptr<SaddleConnection<Surface>>, size_t)>& callback, size_t threads) const {
+  using Search = typename Iterator::Implementation;
+  using Task = std::variant<HalfEdge, Search>;
+
+  if (threads == 0) threads = std::max<size_t>(1, std::thread::hardware_concurrency());
+
+  const Search& search = *impl->begin.impl;
+
+  if constexpr (!std::is_same_v<typename Surface::Vector::Coordinate, long long>) {
+    // Approximate all edges once on this thread. Number fields refine their
+    // embedding lazily when elements are approximated so we make sure that
+    // this happens before the threads approximate concurrently. Later
+    // refinements, by approximations at higher precision or by exact
+    // arithmetic, are serialized, see adaptive::refinement().
+    for (auto e : search.surface->halfEdges())
+      search.surface->fromEdgeApproximate(e);
+  }
+
+  WorkStealingPool<Task> pool(threads);
+  if (search.previous) {
+    // This search continues another search. We report the saddle
+    // connections that it found beyond its search radius directly and
+    // continue in the subsectors where it stopped.
+    for (const auto& connection : search.previous->connections) {
+      if (!(connection.vector > search.searchRadius)) {
+        callback(std::make_unique<SaddleConnection<Surface>>(Search::saddleConnection(search.surface, connection.source, connection.target, connection.vector, search.recordCrossings ? std::optional(connection.crossings) : std::nullopt)), 0);
+        for (size_t image = 1; image < search.images(); image++)
+          callback(search.mapped(image, connection.source, connection.target, connection.crossings), 0);
+      }
+    }
+    for (size_t i = 0; i < search.previous->subsectors.size(); i++) {
+      const auto& subsector = search.previous->subsectors[i];
+      pool.push(i % threads, Search(search.surface, search.searchRadius, subsector.sector, search.approximations, search.window, search.recordCrossings, search.lowerBound, subsector.boundary[0], subsector.boundary[1], subsector.nextEdge, subsector.nextEdgeEnd, subsector.path, search.automorphisms));
+    }
+  } else {
+    for (size_t i = 0; i < search.sectors.size(); i++)
+      pool.push(i % threads, search.sectors[i]);
+  }
+
+  pool.run([&](size_t thread, Task&& task) {
+    std::optional<Search> current;
+    if (auto* sector = std::get_if<HalfEdge>(&task)) {
+      current.emplace(search.surface, search.searchRadius, vector<HalfEdge>{*sector}, search.approximations, search.window, search.recordCrossings, std::nullopt, nullptr, nullptr, search.automorphisms);
+      if (current->sector != current->sectors.size())
+        for (size_t image = 0; image < current->images(); image++)
+          callback(current->connection(image), thread);
+    } else {
+      current.emplace(std::move(std::get<Search>(task)));
+    }
+
+    while (current->sector != current->sectors.size()) {
+      if (pool.hungry() && current->splittable()) {
+        // Another thread is out of work. Hand the counterclockwise part of
+        // our subsector over to it.
+        pool.push(thread, current->split());
+      } else if (current->increment() && current->sector != current->sectors.size()) {
+        for (size_t image = 0; image < current->images(); image++)
+          callback(current->connection(image), thread);
+      }
+    }
+  });
 }
 
 template <typename Surface>
-typename SaddleConnections<Surface>::Iterator SaddleConnections<Surface>::end() const {
-  Iterator ret = impl->begin;
-  ret.impl->sector = ret.impl->sectors.size();
+std::vector<std::unique_ptr<SaddleConnection<Surface>>> SaddleConnections<Surface>::parallel(size_t threads) const {
+  if (threads == 0) threads = std::max<size_t>(1, std::thread::hardware_concurrency());
+
+  vector<vector<std::unique_ptr<SaddleConnection<Surface>>>> found(threads);
+  parallel([&](std::unique_ptr<SaddleConnection<Surface>> connection, size_t thread) {
+    found[thread].push_back(std::move(connection));
+  },
+           threads);
+
+  vector<std::unique_ptr<SaddleConnection<Surface>>> ret;
+  for (auto& connections : found)
+    for (auto& connection : connections)
+      ret.push_back(std::move(connection));
   return ret;
 }
 
+template <typename Surface>
+SaddleConnections<Surface>::Iterator::Iterator() {}
+
 template <typename Surface>
 SaddleConnections<Surface>::Iterator::Iterator(spimpl::impl_ptr<Implementation>&& impl) : impl(std::move(impl)) {}
 
 template <typename Surface>
 bool SaddleConnections<Surface>::Iterator::equal(const SaddleConnections<Surface>::Iterator& other) const {
-  if (impl->surface != other.impl->surface || impl->sectors != other.impl->sectors || impl->searchRadius != other.impl->searchRadius || impl->sector != other.impl->sector)
+  if (!impl || !other.impl) {
+    // One of the iterators is the end() sentinel.
+    return (!impl || impl->sector == impl->sectors.size()) && (!other.impl || other.impl->sector == other.impl->sectors.size());
+  }
+
+  if (impl->surface != other.impl->surface || impl->sectors != other.impl->sectors || impl->searchRadius != other.impl->searchRadius || impl->window != other.impl->window || impl->previous != other.impl->previous || impl->automorphisms != other.impl->automorphisms || impl->sector != other.impl->sector || impl->image != other.impl->image)
     return false;
 
   if (impl->sector == impl->sectors.size())
@@ -432,37 +448,82 @@ bool SaddleConnections<Surface>::Iterator::equal(const SaddleConnections<Surface
 
 template <typename Surface>
 void SaddleConnections<Surface>::Iterator::increment() {
+  if (!impl)
+    throw std::out_of_range("iterator is at end()");
+
+  if (++impl->image < impl->images())
+    return;
+  impl->image = 0;
+
   while (!impl->increment())
     ;
 }
 
 template <typename Surface>
 void SaddleConnections<Surface>::Iterator::skipSector(CCW ccw) {
+  if (!impl)
+    throw std::out_of_range("iterator is at end()");
+  CHECK_ARGUMENT(impl->automorphisms == nullptr, "cannot skip sectors in a search that exploits symmetries");
   impl->skipSector(ccw);
 }
 
 template <typename Surface>
 std::optional<HalfEdge> SaddleConnections<Surface>::Iterator::incrementWithCrossings() {
-  while (true) {
-    if (impl->state.top() == State::START) {
-      impl->applyMoves();
-      auto ret = impl->nextEdge;
-      impl->increment();
-      return ret;
-    } else if (impl->state.top() == State::SADDLE_CONNECTION_FOUND) {
-      return {};
-    } else {
-      impl->increment();
-    }
+  if (!impl)
+    throw std::out_of_range("iterator is at end()");
+  CHECK_ARGUMENT(impl->automorphisms == nullptr, "cannot report crossings in a search that exploits symmetries");
+  return impl->incrementWithCrossings();
+}
+
+template <typename Surface>
+std::optional<typename SaddleConnections<Surface>::Iterator::Statistics> SaddleConnections<Surface>::Iterator::statistics() const {
+#ifdef LIBFLATSURF_STATISTICS
+  // The end() sentinel did not do any work.
+  if (!impl)
+    return Statistics{};
+  return impl->statistics;
+#else
+  return std::nullopt;
+#endif
+}
+
+template <typename Surface>
+typename SaddleConnections<Surface>::Iterator::Checkpoint SaddleConnections<Surface>::Iterator::checkpoint() const {
+  CHECK_ARGUMENT(impl, "cannot checkpoint the end() sentinel");
+  return impl->checkpoint();
+}
+
+template <typename Surface>
+void SaddleConnections<Surface>::Iterator::restore(Checkpoint&& checkpoint) {
+  // (The end() sentinel has no search that we could share anything with.)
+  const bool sameSurface = impl && *checkpoint.surface == *impl->surface;
+
+  std::shared_ptr<const typename Implementation::Window> window;
+  if (checkpoint.window.size()) {
+    CHECK_ARGUMENT(checkpoint.window.size() == 2, "window must be given by two rays");
+    if (impl && impl->window && impl->window->rays[0] == checkpoint.window[0] && impl->window->rays[1] == checkpoint.window[1])
+      window = impl->window;
+    else
+      window = std::make_shared<const typename Implementation::Window>(checkpoint.window[0], checkpoint.window[1]);
   }
+
+  typename Implementation::Automorphisms automorphisms;
+  if (checkpoint.automorphisms.size()) {
+    if (impl && impl->automorphisms && *impl->automorphisms == checkpoint.automorphisms)
+      automorphisms = impl->automorphisms;
+    else
+      automorphisms = std::make_shared<const vector<Permutation<HalfEdge>>>(std::move(checkpoint.automorphisms));
+  }
+
+  impl = spimpl::make_impl<Implementation>(sameSurface ? impl->surface : checkpoint.surface, Bound(checkpoint.searchRadius), std::move(checkpoint.sectors), sameSurface ? impl->approximations : nullptr, std::move(window), checkpoint.crossings, std::move(automorphisms), checkpoint);
 }
 
 template <typename Surface>
 std::unique_ptr<SaddleConnection<Surface>> SaddleConnections<Surface>::Iterator::dereference() const {
-  if (impl->sector == impl->sectors.size()) {
+  if (!impl || impl->sector == impl->sectors.size()) {
     throw std::out_of_range("iterator is at end()");
   }
-  return std::unique_ptr<SaddleConnection<Surface>>(new SaddleConnection<Surface>(impl->surface, impl->sectors[impl->sector], impl->nextEdge, static_cast<typename Surface::Vector>(impl->nextEdgeEnd)));
+  return impl->connection(impl->image);
 }
 
 template <typename Surface>
@@ -481,11 +542,11 @@ namespace flatsurf {
 // We need to explicitly list the operator<< implementations here, since we
 // cannot use a template:
 // https://stackoverflow.com/questions/18823618/overload-operator-for-nested-class-template
-std::ostream& operator<<(std::ostream& os, const typename SaddleConnections<FlatTriangulation<long long>>::Iterator& self) { return os << *self.impl; }
-std::ostream& operator<<(std::ostream& os, const typename SaddleConnections<FlatTriangulation<eantic::renf_elem_class>>::Iterator& self) { return os << *self.impl; }
-std::ostream& operator<<(std::ostream& os, const typename SaddleConnections<FlatTriangulation<exactreal::Element<exactreal::IntegerRing>>>::Iterator& self) { return os << *self.impl; }
-std::ostream& operator<<(std::ostream& os, const typename SaddleConnections<FlatTriangulation<exactreal::Element<exactreal::RationalField>>>::Iterator& self) { return os << *self.impl; }
-std::ostream& operator<<(std::ostream& os, const typename SaddleConnections<FlatTriangulation<exactreal::Element<exactreal::NumberField>>>::Iterator& self) { return os << *self.impl; }
+std::ostream& operator<<(std::ostream& os, const typename SaddleConnections<FlatTriangulation<long long>>::Iterator& self) { return self.impl ? os << *self.impl : os << "Iterator(END)"; }
+std::ostream& operator<<(std::ostream& os, const typename SaddleConnections<FlatTriangulation<eantic::renf_elem_class>>::Iterator& self) { return self.impl ? os << *self.impl : os << "Iterator(END)"; }
+std::ostream& operator<<(std::ostream& os, const typename SaddleConnections<FlatTriangulation<exactreal::Element<exactreal::IntegerRing>>>::Iterator& self) { return self.impl ? os << *self.impl : os << "Iterator(END)"; }
+std::ostream& operator<<(std::ostream& os, const typename SaddleConnections<FlatTriangulation<exactreal::Element<exactreal::RationalField>>>::Iterator& self) { return self.impl ? os << *self.impl : os << "Iterator(END)"; }
+std::ostream& operator<<(std::ostream& os, const typename SaddleConnections<FlatTriangulation<exactreal::Element<exactreal::NumberField>>>::Iterator& self) { return self.impl ? os << *self.impl : os << "Iterator(END)"; }
 
 template class SaddleConnections<FlatTriangulation<long long>>;
 template std::ostream& operator<<(std::ostream&, const SaddleConnections<FlatTriangulation<long long>>&);
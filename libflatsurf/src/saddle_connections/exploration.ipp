@@ -0,0 +1,183 @@
+/**********************************************************************
+ *  This file is part of flatsurf.
+ *
+ *        Copyright (C) 2019 Julian Rüth
+ *
+ *  Flatsurf is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, either version 3 of the License, or
+ *  (at your option) any later version.
+ *
+ *  Flatsurf is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with flatsurf. If not, see <https://www.gnu.org/licenses/>.
+ *********************************************************************/
+
+#ifndef LIBFLATSURF_SADDLE_CONNECTIONS_EXPLORATION_IPP
+#define LIBFLATSURF_SADDLE_CONNECTIONS_EXPLORATION_IPP
+
+#include <cmath>
+#include <memory>
+
+#include "iterator.ipp"
+
+namespace flatsurf {
+namespace {
+// The building blocks of the searches that do not explore the surface
+// depth-first like SaddleConnections does but keep the subsectors they have
+// not explored yet in a queue. Derived decides in which order to explore
+// these subsectors and when to report the saddle connections found, see
+// push() and candidate() in SaddleConnectionsByLength.
+template <typename Surface, typename Search, typename Derived>
+class Exploration {
+ public:
+  using Endpoint = typename Search::Endpoint;
+
+  // Where a boundary passed to Derived::push() comes from: the beginning or
+  // the end of the subsector passed to expand(), the saddle connection that
+  // was passed to candidate() right before, or none of these.
+  enum class Side {
+    BEGIN,
+    END,
+    CONNECTION,
+    NONE,
+  };
+
+  explicit Exploration(const std::shared_ptr<const Surface>& surface, typename Search::Approximations approximations = nullptr) : surface(surface), cursor(surface, Bound(0), vector<HalfEdge>{}, std::move(approximations)), connection(cursor.nextEdgeEnd) {}
+
+  // Queue the sectors next to all the half edges and the saddle connections
+  // that cross these sectors.
+  void start() {
+    for (auto e : surface->halfEdges()) {
+      const HalfEdge next = surface->nextInFace(e);
+      const Endpoint begin(typename Search::AlongTriangulation(surface, vector<HalfEdge>{e}), cursor.approximate(e));
+      connection = Endpoint(begin + next, begin.approximation + cursor.approximate(next));
+      derived().candidate(e, next, connection);
+      derived().push(e, begin, connection, next, connection, {Side::NONE, Side::CONNECTION});
+    }
+  }
+
+  // Search the triangle beyond nextEdge like the START state of
+  // SaddleConnections does and queue the subsectors that the search would
+  // recurse into. The boundaries of these subsectors are the boundaries of
+  // cursor, i.e., the boundaries passed here, or connection, i.e., the saddle
+  // connection that was passed to candidate() right before.
+  void expand(HalfEdge source, Endpoint&& begin, Endpoint&& end, HalfEdge nextEdge, Endpoint&& nextEdgeEnd) {
+    cursor.boundary[0] = std::move(begin);
+    cursor.boundary[1] = std::move(end);
+    cursor.nextEdge = nextEdge;
+    cursor.nextEdgeEnd = std::move(nextEdgeEnd);
+
+    cursor.moves.push_back(Move::GOTO_OTHER_FACE);
+    cursor.moves.push_back(Move::GOTO_NEXT_EDGE);
+    cursor.applyMoves();
+
+    switch (cursor.classifyHalfEdgeEnd()) {
+      case Classification::OUTSIDE_SEARCH_SECTOR_CLOCKWISE:
+        cursor.moves.push_back(Move::GOTO_NEXT_EDGE);
+        cursor.applyMoves();
+        derived().push(source, cursor.boundary[0], cursor.boundary[1], cursor.nextEdge, cursor.nextEdgeEnd, {Side::BEGIN, Side::END});
+        break;
+      case Classification::OUTSIDE_SEARCH_SECTOR_COUNTERCLOCKWISE:
+        derived().push(source, cursor.boundary[0], cursor.boundary[1], cursor.nextEdge, cursor.nextEdgeEnd, {Side::BEGIN, Side::END});
+        break;
+      case Classification::SADDLE_CONNECTION: {
+        connection = cursor.nextEdgeEnd;
+        derived().candidate(source, cursor.nextEdge, connection);
+        derived().push(source, cursor.boundary[0], connection, cursor.nextEdge, cursor.nextEdgeEnd, {Side::BEGIN, Side::CONNECTION});
+        cursor.moves.push_back(Move::GOTO_NEXT_EDGE);
+        cursor.applyMoves();
+        derived().push(source, connection, cursor.boundary[1], cursor.nextEdge, cursor.nextEdgeEnd, {Side::CONNECTION, Side::END});
+        break;
+      }
+    }
+  }
+
+  Approximation approximate(HalfEdge e) const {
+    if constexpr (Search::filtered)
+      return cursor.approximate(e);
+    else
+      return Approximation(surface->fromEdgeApproximate(e));
+  }
+
+  Approximation approximate(const Endpoint& v) const {
+    if constexpr (Search::filtered)
+      return v.approximation;
+    else
+      return Approximation(static_cast<Vector<exactreal::Arb>>(static_cast<typename Surface::Vector>(v)));
+  }
+
+  // Return a lower bound for the length of the saddle connections in the
+  // subsector beyond nextEdge. Since nextEdge crosses the subsector
+  // completely, this is the distance of the origin from nextEdge.
+  double distance(HalfEdge nextEdge, const Endpoint& nextEdgeEnd) const {
+    Approximation nextEdgeStart = approximate(nextEdgeEnd);
+    nextEdgeStart -= approximate(nextEdge);
+    return distance(nextEdgeStart, approximate(nextEdgeEnd));
+  }
+
+  // Return an upper bound for the length of v.
+  static double length(const Approximation& v) noexcept {
+    return std::hypot(std::abs(v.x) + v.error, std::abs(v.y) + v.error) * Approximation::safety;
+  }
+
+  // Return whether a subsector at distance d (see distance()) lies beyond
+  // the search radius entirely.
+  static bool exceeds(double d, const Bound searchRadius) noexcept {
+    return d > static_cast<double>(searchRadius.length()) * Approximation::safety;
+  }
+
+  // Return a lower bound for the distance of the origin from the segment
+  // between a and b.
+  static double distance(const Approximation& a, const Approximation& b) noexcept {
+    constexpr double u = Approximation::u;
+
+    const double dx = b.x - a.x;
+    const double dy = b.y - a.y;
+    const double d = std::hypot(dx, dy);
+    const double na = std::hypot(a.x, a.y);
+    const double nb = std::hypot(b.x, b.y);
+
+    double ret = 0;
+    if (d != 0) {
+      // The parameter of the point on the line through a and b that is
+      // closest to the origin, and how far off it might be due to rounding.
+      const double t = -(a.x * dx + a.y * dy) / (d * d);
+      const double slack = 16 * u * (na + nb) / d;
+      if (t < -slack) {
+        ret = na;
+      } else if (t > 1 + slack) {
+        ret = nb;
+      } else {
+        // The distance from the line, which is a lower bound in any case.
+        const double p = a.x * dy;
+        const double q = a.y * dx;
+        ret = std::max(0., std::abs(p - q) - 4 * u * (std::abs(p) + std::abs(q))) / d;
+      }
+    } else {
+      ret = std::min(na, nb);
+    }
+
+    // The actual segment lies within the errors of the approximations (and
+    // the rounding of b - a.)
+    const double error = std::max(a.error, b.error) + u * (std::abs(dx) + std::abs(dy));
+    return ret * (1 - 8 * u) - (std::sqrt(2.) * error + Approximation::tiny) * Approximation::safety;
+  }
+
+  Derived& derived() { return static_cast<Derived&>(*this); }
+
+  std::shared_ptr<const Surface> surface;
+  // A search that we only use to move across the surface and to classify
+  // vertices; its own state is meaningless.
+  Search cursor;
+  // The saddle connection found last.
+  Endpoint connection;
+};
+}  // namespace
+}  // namespace flatsurf
+
+#endif
@@ -0,0 +1,1405 @@
+/**********************************************************************
+ *  This file is part of flatsurf.
+ *
+ *        Copyright (C) 2019 Julian Rüth
+ *
+ *  Flatsurf is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, either version 3 of the License, or
+ *  (at your option) any later version.
+ *
+ *  Flatsurf is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with flatsurf. If not, see <https://www.gnu.org/licenses/>.
+ *********************************************************************/
+
+#ifndef LIBFLATSURF_SADDLE_CONNECTIONS_ITERATOR_IPP
+#define LIBFLATSURF_SADDLE_CONNECTIONS_ITERATOR_IPP
+
+#include <algorithm>
+#include <cmath>
+#include <complex>
+#include <exact-real/arb.hpp>
+#include <intervalxt/length.hpp>
+#include <mutex>
+#include <variant>
+
+#include "flatsurf/flat_triangulation.hpp"
+#include "flatsurf/half_edge.hpp"
+#include "flatsurf/half_edge_map.hpp"
+#include "flatsurf/permutation.hpp"
+#include "flatsurf/saddle_connection.hpp"
+#include "flatsurf/saddle_connections.hpp"
+#include "flatsurf/vector.hpp"
+#include "flatsurf/vector_along_triangulation.hpp"
+
+#include "flatsurf/config.h"
+
+#include "../util/assert.ipp"
+#include "../util/recycling_stack.ipp"
+#include "../util/ring_buffer.ipp"
+#include "../vector/adaptive.ipp"
+#include "../vector/approximation.ipp"
+
+#ifdef LIBFLATSURF_COROUTINES
+#include "../util/recursive_coroutine.ipp"
+#endif
+
+// Count the work of the search in its statistics, see
+// Iterator::statistics(). This compiles to nothing unless configured with
+// --enable-statistics.
+#ifdef LIBFLATSURF_STATISTICS
+#define STATISTICS(...) __VA_ARGS__
+#else
+#define STATISTICS(...)
+#endif
+
+using std::vector;
+namespace {
+enum class Classification {
+  OUTSIDE_SEARCH_SECTOR_CLOCKWISE,
+  SADDLE_CONNECTION,
+  OUTSIDE_SEARCH_SECTOR_COUNTERCLOCKWISE,
+};
+
+enum class State {
+  START,
+  OUTSIDE_SEARCH_SECTOR_CLOCKWISE_SEARCHING,
+  OUTSIDE_SEARCH_SECTOR_COUNTERCLOCKWISE_SEARCHING,
+  SADDLE_CONNECTION_FOUND,
+  SADDLE_CONNECTION_FOUND_SEARCHING_FIRST,
+  SADDLE_CONNECTION_FOUND_SEARCHING_SECOND,
+  END,
+};
+
+enum class Move {
+  GOTO_OTHER_FACE,
+  GOTO_NEXT_EDGE,
+  GOTO_PREVIOUS_EDGE,
+};
+
+#ifdef LIBFLATSURF_COROUTINES
+// What the search coroutine reports when it suspends.
+enum class Event {
+  CROSSING,
+  SADDLE_CONNECTION,
+};
+#endif
+}  // namespace
+
+namespace flatsurf {
+template <typename Surface>
+class SaddleConnections<Surface>::Implementation {
+ public:
+  Implementation(Iterator&& begin) noexcept : begin(std::move(begin)) {}
+
+  Iterator begin;
+};
+
+template <typename Surface>
+class SaddleConnections<Surface>::Iterator::Implementation {
+ public:
+  using AlongTriangulation = VectorAlongTriangulation<typename Surface::Vector::Coordinate, std::conditional_t<std::is_same_v<typename Surface::Vector::Coordinate, long long>, void, exactreal::Arb>>;
+
+  // Whether to decide predicates with floating point approximations first,
+  // see classifyHalfEdgeEnd(). For long long coordinates, the exact
+  // predicates are just as cheap.
+  static constexpr bool filtered = !std::is_same_v<typename Surface::Vector::Coordinate, long long>;
+
+  // A vector of the search together with its floating point approximation.
+  struct Endpoint : AlongTriangulation {
+    Endpoint(const AlongTriangulation& vector, const Approximation& approximation) : AlongTriangulation(vector), approximation(approximation) {}
+
+    Approximation approximation;
+    // Whether this boundary of the search sector has been replaced by the
+    // corresponding ray of the window, see clip().
+    bool clipped = false;
+  };
+
+  using Approximations = std::shared_ptr<const vector<Approximation>>;
+
+  using Automorphisms = std::shared_ptr<const vector<Permutation<HalfEdge>>>;
+
+  // The directions that the search is restricted to, i.e., the directions
+  // strictly between the two rays in counterclockwise order.
+  struct Window {
+    Window(const typename Surface::Vector& begin, const typename Surface::Vector& end) : rays{begin, end}, approximations{approximate(begin), approximate(end)} {}
+
+    static Approximation approximate(const typename Surface::Vector& ray) {
+      if constexpr (filtered)
+        return Approximation(static_cast<Vector<exactreal::Arb>>(ray));
+      else
+        return {};
+    }
+
+    typename Surface::Vector rays[2];
+    Approximation approximations[2];
+  };
+
+  // Where a search with a larger search radius needs to pick up the work of
+  // a complete search, see grow().
+  struct Frontier {
+    // A saddle connection that was found beyond the search radius.
+    struct Connection {
+      HalfEdge source;
+      HalfEdge target;
+      Endpoint vector;
+      std::vector<HalfEdge> crossings;
+    };
+
+    // A subsector the search did not descend into because the triangle
+    // that it was about to cross (nextEdge) lies beyond the search radius
+    // entirely.
+    struct Subsector {
+      HalfEdge sector;
+      Endpoint boundary[2];
+      HalfEdge nextEdge;
+      Endpoint nextEdgeEnd;
+      vector<HalfEdge> path;
+    };
+
+    vector<Connection> connections;
+    vector<Subsector> subsectors;
+    // Whether the crossings and paths have been recorded.
+    bool crossings = false;
+  };
+
+  // The frontier of a search, once one of its iterators has run to the end.
+  // Shared by all the copies of the iterator.
+  struct Published {
+    std::mutex lock;
+    std::shared_ptr<const Frontier> frontier;
+  };
+
+  // If previous is set, this search continues where another search stopped,
+  // and the sectors are the sources of previous' connections, followed by the
+  // sectors of its subsectors. If published is set, the search records its
+  // frontier and publishes it there once it is complete. If automorphisms is
+  // set, the sectors are representatives of their orbits, see
+  // withSymmetries().
+  Implementation(const std::shared_ptr<const Surface>& surface, const Bound searchRadius, const vector<HalfEdge> searchSectors, Approximations approximations = nullptr, std::shared_ptr<const Window> window = nullptr, bool recordCrossings = false, std::optional<Bound> lowerBound = {}, std::shared_ptr<const Frontier> previous = nullptr, std::shared_ptr<Published> published = nullptr, Automorphisms automorphisms = nullptr) : surface(std::move(surface)), searchRadius(searchRadius), sectors(std::move(searchSectors)), sector(0), approximations(std::move(approximations)), window(std::move(window)), recordCrossings((recordCrossings || automorphisms != nullptr) && (previous == nullptr || previous->crossings)), automorphisms(std::move(automorphisms)), lowerBound(std::move(lowerBound)), previous(std::move(previous)), published(std::move(published)), boundary{Endpoint(AlongTriangulation(this->surface), {}), Endpoint(AlongTriangulation(this->surface), {})}, nextEdgeEnd(AlongTriangulation(this->surface), {}) {
+    if constexpr (filtered) {
+      if (this->approximations == nullptr)
+        this->approximations = approximateEdges(*this->surface);
+    }
+
+    if (this->published) {
+      frontier.emplace();
+      frontier->crossings = this->recordCrossings;
+    }
+
+    if (sectors.size()) {
+      if (!prepareSearch()) {
+        while (!increment())
+          ;
+      }
+    } else {
+      publish();
+    }
+  }
+
+  // A search in the subsector between begin and end (in counterclockwise
+  // order) of the sector starting at sectorBegin that is about to cross
+  // nextEdge after crossing the half edges in path.
+  Implementation(const std::shared_ptr<const Surface>& surface, const Bound searchRadius, HalfEdge sectorBegin, Approximations approximations, std::shared_ptr<const Window> window, bool recordCrossings, std::optional<Bound> lowerBound, const Endpoint& begin, const Endpoint& end, HalfEdge nextEdge, const Endpoint& nextEdgeEnd, vector<HalfEdge> path, Automorphisms automorphisms = nullptr) : surface(surface), searchRadius(searchRadius), sectors{sectorBegin}, sector(0), approximations(std::move(approximations)), window(std::move(window)), recordCrossings(recordCrossings), automorphisms(std::move(automorphisms)), lowerBound(std::move(lowerBound)), boundary{begin, end}, nextEdge(nextEdge), nextEdgeEnd(nextEdgeEnd), path(std::move(path)) {
+#ifndef LIBFLATSURF_COROUTINES
+    state.push(State::END);
+    state.push(State::START);
+#endif
+  }
+
+  // Restore a search in sectors from a checkpoint, see checkpoint().
+  Implementation(const std::shared_ptr<const Surface>& surface, const Bound searchRadius, const vector<HalfEdge> searchSectors, Approximations approximations, std::shared_ptr<const Window> window, bool recordCrossings, Automorphisms automorphisms, const typename Iterator::Checkpoint& checkpoint) : surface(surface), searchRadius(searchRadius), sectors(std::move(searchSectors)), sector(checkpoint.sector), approximations(std::move(approximations)), window(std::move(window)), recordCrossings(recordCrossings), automorphisms(std::move(automorphisms)), image(checkpoint.image), boundary{Endpoint(AlongTriangulation(this->surface), {}), Endpoint(AlongTriangulation(this->surface), {})}, nextEdgeEnd(AlongTriangulation(this->surface), {}) {
+    CHECK_ARGUMENT(sector <= sectors.size() && image < images(), "checkpoint does not describe an iterator of this search");
+
+    if constexpr (filtered) {
+      if (this->approximations == nullptr)
+        this->approximations = approximateEdges(*this->surface);
+    }
+
+    if (sector != sectors.size()) {
+      prepareSearch();
+      restore(checkpoint);
+    }
+  }
+
+  // Return floating point approximations of all the half edges of surface,
+  // see approximations.
+  static Approximations approximateEdges(const Surface& surface) {
+    auto edges = std::make_shared<vector<Approximation>>(surface.halfEdges().size());
+    for (auto e : surface.halfEdges())
+      (*edges)[HalfEdgeMap<int>::index(e)] = Approximation(surface.fromEdgeApproximate(e));
+    return edges;
+  }
+
+  // Return a description of the state of this search from which the above
+  // constructor can restore it.
+  typename Iterator::Checkpoint checkpoint() const {
+    CHECK_ARGUMENT(previous == nullptr, "cannot checkpoint a search that continues another search");
+
+    typename Iterator::Checkpoint checkpoint{surface, searchRadius.length(), sectors, {}, recordCrossings, {}, sector, image, {}, {}};
+    if (window)
+      checkpoint.window = {window->rays[0], window->rays[1]};
+    if (automorphisms)
+      checkpoint.automorphisms = *automorphisms;
+
+    if (sector != sectors.size()) {
+#ifdef LIBFLATSURF_COROUTINES
+      // A coroutine cannot be serialized, so we record how to replay it
+      // instead, see replay().
+      const bool started = engine.coroutine.has_value() || engine.replaying;
+      checkpoint.log = {engine.skipped, started, started ? engine.origin->crossings : engine.crossings, engine.atConnection, engine.steps};
+      for (const auto& request : engine.log) {
+        checkpoint.log.push_back(request.first);
+        checkpoint.log.push_back(request.second ? (*request.second == CCW::CLOCKWISE ? 1 : 2) : 0);
+      }
+#else
+      for (size_t i = 0; i < state.size(); i++)
+        checkpoint.stack.push_back(static_cast<std::uint8_t>(state[i]));
+#endif
+    }
+
+    return checkpoint;
+  }
+
+  // Prepare the search in sectors[sector]. Return whether the search starts
+  // at a saddle connection that should be reported.
+  bool prepareSearch() {
+#ifdef LIBFLATSURF_COROUTINES
+    engine.reset();
+#else
+    assert(state.size() == 0);
+#endif
+    assert(tmp.size() == 0);
+    assert(moves.size() == 0);
+    STATISTICS(depth = 0);
+
+    if (previous) {
+      if (sector < previous->connections.size()) {
+        // Report a saddle connection that the search we continue found
+        // beyond its search radius. There is nothing else to search here.
+        const auto& connection = previous->connections[sector];
+        nextEdge = connection.target;
+        nextEdgeEnd = connection.vector;
+        path = connection.crossings;
+#ifdef LIBFLATSURF_COROUTINES
+        engine.skipped = true;
+#else
+        state.push(State::END);
+#endif
+        return reportable();
+      }
+
+      // Continue the search in a subsector that the search we continue did
+      // not descend into.
+      const auto& subsector = previous->subsectors[sector - previous->connections.size()];
+      boundary[0] = subsector.boundary[0];
+      boundary[1] = subsector.boundary[1];
+      nextEdge = subsector.nextEdge;
+      nextEdgeEnd = subsector.nextEdgeEnd;
+      path = subsector.path;
+#ifndef LIBFLATSURF_COROUTINES
+      state.push(State::END);
+      state.push(State::START);
+#endif
+      return false;
+    }
+
+    const HalfEdge e = sectors[sector];
+    path.clear();
+    boundary[0] = Endpoint(AlongTriangulation(surface, vector<HalfEdge>{e}), approximate(e));
+    nextEdge = surface->nextInFace(e);
+    boundary[1] = Endpoint(boundary[0] + nextEdge, boundary[0].approximation + approximate(nextEdge));
+    nextEdgeEnd = boundary[1];
+
+    if (window && !clip()) {
+      // None of the directions in this sector are inside the window.
+#ifdef LIBFLATSURF_COROUTINES
+      engine.skipped = true;
+#else
+      state.push(State::END);
+#endif
+      return false;
+    }
+
+#ifndef LIBFLATSURF_COROUTINES
+    state.push(State::END);
+    state.push(State::START);
+#endif
+
+    // Report nextEdgeEnd as a saddle connection unless it's already outside
+    // of the search radius (or outside of the window.)
+    return !boundary[1].clipped && reportable();
+  }
+
+  // Restrict the search sector to the directions inside the window by
+  // replacing its boundaries with the rays of the window where necessary.
+  // Since the sector and the window are both less than π wide, their
+  // intersection is again such a sector. Return whether it is non-empty.
+  bool clip() {
+    const CCW begin0 = ccwWindow(0, boundary[0]);
+    const CCW begin1 = ccwWindow(0, boundary[1]);
+    const CCW end0 = ccwWindow(1, boundary[0]);
+    const CCW end1 = ccwWindow(1, boundary[1]);
+
+    // The window begins in [boundary[0], boundary[1]).
+    boundary[0].clipped = begin0 != CCW::COUNTERCLOCKWISE && begin1 == CCW::COUNTERCLOCKWISE;
+    // Otherwise, the sector must begin inside the window.
+    if (!boundary[0].clipped && !(begin0 == CCW::COUNTERCLOCKWISE && end0 == CCW::CLOCKWISE))
+      return false;
+    // The window ends in (boundary[0], boundary[1]].
+    boundary[1].clipped = end0 == CCW::CLOCKWISE && end1 != CCW::CLOCKWISE;
+    return true;
+  }
+
+  // Return whether the saddle connection at nextEdgeEnd should be reported,
+  // i.e., whether it is within the search radius and has not been reported
+  // by the search we continue.
+  bool reportable() {
+    if (nextEdgeEnd > searchRadius) {
+      recordConnection();
+      return false;
+    }
+    return !lowerBound || nextEdgeEnd > *lowerBound;
+  }
+
+  // Record the saddle connection at nextEdgeEnd, which is beyond the search
+  // radius, in the frontier.
+  void recordConnection() {
+    if (frontier) {
+      applyMoves();
+      frontier->connections.push_back({sectors[sector], nextEdge, nextEdgeEnd, path});
+    }
+  }
+
+  // Record that the search does not descend into the triangle beyond
+  // nextEdge in the frontier.
+  void recordSubsector() {
+    if (frontier) {
+      applyMoves();
+      frontier->subsectors.push_back({sectors[sector], {boundary[0], boundary[1]}, nextEdge, nextEdgeEnd, path});
+    }
+  }
+
+  // Cross nextEdge into the triangle beyond it and classify the vertex
+  // opposite to it. This is how the START of increment() (and of the search
+  // coroutine and branch()) begins.
+  Classification descend() {
+    moves.push_back(Move::GOTO_OTHER_FACE);
+    moves.push_back(Move::GOTO_NEXT_EDGE);
+
+    applyMoves();
+    return classifyHalfEdgeEnd();
+  }
+
+  // Return whether the other two vertices of the triangle are beyond the
+  // search radius, after descend() found a saddle connection beyond the
+  // search radius. If so, the search does not need to go beyond this
+  // triangle. Since this walks along the triangle, the search is then at the
+  // edge before the one that descend() left it at.
+  bool baseExceedsSearchRadius() {
+    bool ret = true;
+    for (int i = 0; i < 2; i++) {
+      moves.push_back(Move::GOTO_NEXT_EDGE);
+      applyMoves();
+      ret &= nextEdgeEnd > searchRadius;
+    }
+    return ret;
+  }
+
+  // Make the frontier available to grow() once the search is complete.
+  void publish() {
+    if (published && frontier) {
+      std::lock_guard<std::mutex> lock(published->lock);
+      if (!published->frontier)
+        published->frontier = std::make_shared<const Frontier>(std::move(*frontier));
+      frontier.reset();
+    }
+  }
+
+  // Advance to the next sector once the current one has been searched
+  // completely. Return whether we are now at a saddle connection that should
+  // be reported (or at the end of the search.)
+  bool nextSector() {
+    applyMoves();
+    sector++;
+    if (sector != sectors.size())
+      return prepareSearch();
+    publish();
+    return true;
+  }
+
+  std::shared_ptr<const Surface> surface;
+  const Bound searchRadius;
+  const vector<HalfEdge> sectors;
+  // The half edge nextEdge, to which we are currently changing, points into
+  // sectors. Advanced when we are done searching an entire such sector for all
+  // saddle connections. (An index into sectors.)
+  size_t sector;
+
+  // Floating point approximations of all the half edges of the surface
+  // (indexed by HalfEdgeMap::index()), shared by all the searches on this
+  // surface. We track approximations of boundary and nextEdgeEnd with them.
+  // (Only when filtered is set.)
+  Approximations approximations;
+
+  // If set, the search is restricted to the directions in this window.
+  std::shared_ptr<const Window> window;
+
+  // Whether to track the half edges crossed on the way to nextEdgeEnd in path
+  // so that the saddle connections we report know their crossings.
+  bool recordCrossings;
+
+  // If set, sectors only contains one sector of every orbit of these
+  // automorphisms of the surface, and the saddle connections in the other
+  // sectors are the images of the ones we find. (We need their crossings to
+  // compute these images, so recordCrossings is then set as well.)
+  Automorphisms automorphisms;
+  // The automorphism that maps the saddle connection at nextEdgeEnd to the
+  // one that the iterator is at (an index into automorphisms.)
+  size_t image = 0;
+
+  // Saddle connections of at most this length are not reported since the
+  // search that this search continues has reported them already.
+  std::optional<Bound> lowerBound;
+  // The frontier of the search that this search continues, see grow().
+  std::shared_ptr<const Frontier> previous;
+  // Where to publish the frontier of this search, see grow().
+  std::shared_ptr<Published> published;
+  // The frontier recorded so far. (Only when published is set.)
+  std::optional<Frontier> frontier;
+
+  // The rays that enclose the search sector, in counterclockwise order. They
+  // themselves come from saddle connections, starting at the search origin and
+  // pointing to a vertex of the flat triangulation.
+  Endpoint boundary[2];
+  // The half-edge that we are about to cross, seen from the search origin,
+  // i.e., oriented so that it starts on the side of boundary[0]
+  HalfEdge nextEdge;
+  // The vector to the target of nextEdge
+  Endpoint nextEdgeEnd;
+  // The half edges that the recursive search crossed to get to the triangle
+  // that we are in, i.e., the half edges at the START of the subsector
+  // searches that we are currently in. (Only when recordCrossings is set.)
+  vector<HalfEdge> path;
+
+#ifdef LIBFLATSURF_COROUTINES
+  // The state of the search before the search coroutine started, see replay().
+  struct Origin {
+    Endpoint boundary[2];
+    HalfEdge nextEdge;
+    Endpoint nextEdgeEnd;
+    vector<HalfEdge> path;
+    RingBuffer<Move> moves;
+    bool crossings;
+  };
+
+  // The search coroutine, see search(), and how it has been steered so far.
+  struct Engine {
+    Engine() = default;
+    // Coroutine frames cannot be copied, so a copy of a running engine
+    // recreates the coroutine by replaying the search, see replay().
+    Engine(const Engine& other) : crossings(other.crossings), skipped(other.skipped), atConnection(other.atConnection), skip(other.skip), steps(other.steps), log(other.log), origin(other.origin), replaying(other.coroutine.has_value() || other.replaying) {}
+    Engine(Engine&&) = default;
+    Engine& operator=(Engine&&) = default;
+
+    // Prepare the engine for the search of another sector.
+    void reset() {
+      coroutine.reset();
+      skipped = false;
+      atConnection = false;
+      skip.reset();
+      steps = 0;
+      log.clear();
+      origin.reset();
+      replaying = false;
+    }
+
+    // The search the coroutine operates on. Since searches move around, the
+    // coroutine looks it up here whenever it resumes.
+    std::unique_ptr<Implementation*> self = std::make_unique<Implementation*>(nullptr);
+    std::optional<RecursiveCoroutine<Event>> coroutine;
+    // Whether the coroutine also reports every half edge that it crosses.
+    bool crossings = false;
+    // Whether the entire sector has been skipped before the coroutine started.
+    bool skipped = false;
+    // Whether the coroutine just reported a saddle connection.
+    bool atConnection = false;
+    // The subsector next to the saddle connection just reported that the
+    // coroutine should not descend into.
+    std::optional<CCW> skip;
+    // The number of events reported by the coroutine in this sector.
+    size_t steps = 0;
+    // The skip and crossings (if no skip is set) requests after the given
+    // number of steps in this sector.
+    std::vector<std::pair<size_t, std::optional<CCW>>> log;
+    std::optional<Origin> origin;
+    // Whether this is a copy that still needs to recreate its coroutine.
+    bool replaying = false;
+  };
+
+  // With C++20 coroutines, the recursion of the search lives in coroutine
+  // frames, see search().
+  Engine engine;
+#else
+  // The call stack for increment().
+  // As of early 2019, C++ lacks stackless coroutines. This code would be much
+  // more readable with async/await idioms. And likely faster.
+  // Unfortunately, boost's coroutines are not stackless and therefore too
+  // slow, and co2 exceeds the stack size quickly, so we have to roll our own
+  // stack for the time being.
+  // At the same time, we cannot make recursive calls inside this function,
+  // i.e., "return increment()" since that also exceeds the stack size for
+  // (much larger) radii. (Strangely, GCC, as of early 2019, does not
+  // optimize such tail recursion.)
+  // When configured with --enable-coroutines, we use C++20 coroutines
+  // instead, see search().
+  RecyclingStack<State> state;
+#endif
+
+  // Storage space for temporary values of boundary, when we descend
+  // recursively into a subsector. Since the stack keeps the values it pops,
+  // pushing to it assigns to an existing vector in place and does not need
+  // to allocate once the stack has been as deep before, not even when
+  // searching the next sector.
+  RecyclingStack<Endpoint> tmp;
+
+  // We collect pending moves across the surface here (adding half edges to
+  // nextEdgeEnd mostly.) When the exact value of nextEdgeEnd is required, we
+  // can often combine several move more efficiently, see applyMoves().
+  RingBuffer<Move> moves;
+
+#ifdef LIBFLATSURF_STATISTICS
+  // The work this search has done so far, see Iterator::statistics(). (The
+  // predicates, which are const, count as well.)
+  mutable typename Iterator::Statistics statistics;
+  // The number of triangles that the search is currently deep.
+  size_t depth = 0;
+
+  // Record that the search enters the triangle beyond nextEdge.
+  void enter() {
+    statistics.triangles++;
+    statistics.depth = std::max(statistics.depth, ++depth);
+  }
+#endif
+
+#ifdef LIBFLATSURF_COROUTINES
+  // The saddle connection search as a recursive coroutine: search the
+  // subsector enclosed by boundary that lies beyond nextEdge. This is the
+  // same search that the state machine in the non-coroutine version of
+  // increment() performs.
+  static RecursiveCoroutine<Event> search(Implementation* const& self) {
+    STATISTICS(self->enter());
+
+    if (self->recordCrossings)
+      self->path.push_back(self->crossing());
+
+    if (self->engine.crossings) {
+      self->applyMoves();
+      co_yield Event::CROSSING;
+    }
+
+    switch (self->descend()) {
+      case Classification::OUTSIDE_SEARCH_SECTOR_CLOCKWISE:
+        self->moves.push_back(Move::GOTO_NEXT_EDGE);
+        co_await search(self);
+        break;
+      case Classification::OUTSIDE_SEARCH_SECTOR_COUNTERCLOCKWISE:
+        co_await search(self);
+        self->moves.push_back(Move::GOTO_NEXT_EDGE);
+        break;
+      case Classification::SADDLE_CONNECTION: {
+        if (!(self->nextEdgeEnd > self->searchRadius)) {
+          if (self->reportable())
+            co_yield Event::SADDLE_CONNECTION;
+        } else {
+          if (self->baseExceedsSearchRadius()) {
+            self->moves.push_back(Move::GOTO_OTHER_FACE);
+            if (self->recordCrossings)
+              self->path.pop_back();
+            self->recordSubsector();
+            STATISTICS(self->statistics.pruned++);
+            STATISTICS(self->depth--);
+            co_return;
+          }
+          self->moves.push_back(Move::GOTO_NEXT_EDGE);
+          self->recordConnection();
+        }
+
+        const auto skip = std::exchange(self->engine.skip, std::nullopt);
+
+        // Descend into the clockwise subsector.
+        self->tmp.push(self->boundary[1]);
+        self->applyMoves();
+        self->boundary[1] = self->nextEdgeEnd;
+        if (skip != CCW::CLOCKWISE)
+          co_await search(self);
+        self->boundary[1] = self->tmp.top();
+        self->tmp.pop();
+
+        // Descend into the counterclockwise subsector.
+        self->tmp.push(self->boundary[0]);
+        self->applyMoves();
+        self->boundary[0] = self->nextEdgeEnd;
+        self->moves.push_back(Move::GOTO_NEXT_EDGE);
+        if (skip != CCW::COUNTERCLOCKWISE)
+          co_await search(self);
+        self->boundary[0] = self->tmp.top();
+        self->tmp.pop();
+        break;
+      }
+    }
+
+    self->moves.push_back(Move::GOTO_NEXT_EDGE);
+    self->moves.push_back(Move::GOTO_OTHER_FACE);
+    if (self->recordCrossings)
+      self->path.pop_back();
+    STATISTICS(self->depth--);
+  }
+
+  // Run the search coroutine until it reports something. Return nothing if
+  // the current sector has been searched completely.
+  std::optional<Event> resume() {
+    if (engine.replaying)
+      replay();
+    if (engine.skipped)
+      return {};
+    if (!engine.coroutine) {
+      engine.origin.emplace(Origin{{boundary[0], boundary[1]}, nextEdge, nextEdgeEnd, path, moves, engine.crossings});
+      engine.coroutine.emplace(search(*engine.self));
+    }
+
+    *engine.self = this;
+    engine.atConnection = false;
+    auto event = engine.coroutine->resume();
+    if (event) {
+      engine.steps++;
+      engine.atConnection = *event == Event::SADDLE_CONNECTION;
+    }
+    return event;
+  }
+
+  // Recreate the coroutine of a copied search by running the search in this
+  // sector again with the same requests. This is expensive but copies of
+  // running searches are rare.
+  void replay() {
+    assert(engine.replaying && engine.origin);
+
+    const size_t steps = engine.steps;
+    const auto log = engine.log;
+    const bool atConnection = engine.atConnection;
+    const Origin& origin = *engine.origin;
+    // The frontier already contains what the search records on its way.
+    auto recorded = std::exchange(frontier, std::nullopt);
+
+    boundary[0] = origin.boundary[0];
+    boundary[1] = origin.boundary[1];
+    nextEdge = origin.nextEdge;
+    nextEdgeEnd = origin.nextEdgeEnd;
+    path = origin.path;
+    moves = origin.moves;
+    tmp.clear();
+    STATISTICS(depth = 0);
+    engine.crossings = origin.crossings;
+    engine.skip.reset();
+    engine.replaying = false;
+    engine.coroutine.emplace(search(*engine.self));
+    *engine.self = this;
+
+    auto request = log.begin();
+    for (size_t step = 0;; step++) {
+      for (; request != log.end() && request->first == step; request++) {
+        if (request->second)
+          engine.skip = request->second;
+        else
+          engine.crossings = true;
+      }
+      if (step == steps)
+        break;
+      engine.coroutine->resume();
+    }
+
+    engine.atConnection = atConnection;
+    frontier = std::move(recorded);
+  }
+
+  // Bring the search, which has just been prepared for the search in
+  // sectors[sector], into the state described by checkpoint, see
+  // checkpoint(), by replaying the search in this sector.
+  void restore(const typename Iterator::Checkpoint& checkpoint) {
+    const auto& log = checkpoint.log;
+    CHECK_ARGUMENT(log.size() >= 5 && log.size() % 2 == 1, "checkpoint does not describe an iterator of a search with coroutines");
+
+    engine.skipped = log[0];
+    engine.atConnection = log[3];
+    engine.steps = log[4];
+    for (size_t i = 5; i < log.size(); i += 2) {
+      CHECK_ARGUMENT(log[i + 1] <= 2, "checkpoint does not describe an iterator of a search with coroutines");
+      engine.log.emplace_back(log[i], log[i + 1] == 0 ? std::nullopt : std::optional<CCW>(log[i + 1] == 1 ? CCW::CLOCKWISE : CCW::COUNTERCLOCKWISE));
+    }
+
+    if (log[1]) {
+      engine.origin.emplace(Origin{{boundary[0], boundary[1]}, nextEdge, nextEdgeEnd, path, moves, static_cast<bool>(log[2])});
+      engine.replaying = true;
+      replay();
+    } else {
+      engine.crossings = log[2];
+    }
+  }
+
+  bool increment() {
+    assert(sector != sectors.size());
+
+    while (true) {
+      if (auto event = resume())
+        return *event == Event::SADDLE_CONNECTION;
+
+      // The search in this sector is complete.
+      if (nextSector())
+        return true;
+      // The next sector does not start with a saddle connection that we
+      // report, so we continue to search there.
+    }
+  }
+
+  void skipSector(CCW sector) {
+    ASSERT_ARGUMENT(sector != CCW::COLLINEAR,
+                    "There is no such thing like a collinear sector.");
+
+    // The search is not going to be complete, so there is no frontier to
+    // record anymore.
+    frontier.reset();
+
+    if (engine.replaying)
+      replay();
+
+    if (engine.atConnection) {
+      engine.log.emplace_back(engine.steps, sector);
+      engine.skip = sector;
+      engine.atConnection = false;
+    } else if (!engine.coroutine && !engine.skipped) {
+      // We are in the initial state, see the non-coroutine version.
+      if (sector == CCW::CLOCKWISE)
+        engine.skipped = true;
+    } else {
+      throw std::logic_error(
+          "sectors can only be skipped when a saddle connection has been "
+          "reported");
+    }
+  }
+
+  // Return whether the search just found a saddle connection, i.e., whether
+  // we can split() here.
+  bool splittable() const {
+    return engine.atConnection;
+  }
+
+  std::optional<HalfEdge> incrementWithCrossings() {
+    if (engine.replaying)
+      replay();
+
+    if (!engine.crossings) {
+      engine.crossings = true;
+      engine.log.emplace_back(engine.steps, std::nullopt);
+    }
+
+    while (true) {
+      if (engine.atConnection)
+        return {};
+      if (!increment())
+        return nextEdge;
+    }
+  }
+#else
+  bool increment() {
+    assert(state.size());
+    assert(sector != sectors.size());
+    // (The boundary is not set when we only report a saddle connection of a
+    // frontier, see prepareSearch().)
+    assert(state.top() == State::END || boundary[0].clipped || boundary[1].clipped || boundary[0].ccw(boundary[1]) == CCW::COUNTERCLOCKWISE);
+
+    const auto s = state.top();
+    state.pop();
+    switch (s) {
+      case State::END:
+        return nextSector();
+      case State::START:
+        STATISTICS(enter());
+
+        if (recordCrossings)
+          path.push_back(crossing());
+
+        switch (descend()) {
+          case Classification::OUTSIDE_SEARCH_SECTOR_CLOCKWISE:
+            // Since this vertex is outside of the search sector on the
+            // clockwise side, we skip the clockwise sector in the recursive
+            // search and recurse into the counterclockwise sector.
+            moves.push_back(Move::GOTO_NEXT_EDGE);
+            // Note that the following is a nop that just exists for symmetry.
+            state.push(State::OUTSIDE_SEARCH_SECTOR_CLOCKWISE_SEARCHING);
+            state.push(State::START);
+            return false;
+          case Classification::OUTSIDE_SEARCH_SECTOR_COUNTERCLOCKWISE:
+            // Similarly, we skip the counterclockwise sector.
+            state.push(State::OUTSIDE_SEARCH_SECTOR_COUNTERCLOCKWISE_SEARCHING);
+            state.push(State::START);
+            return false;
+          case Classification::SADDLE_CONNECTION:
+            state.push(State::SADDLE_CONNECTION_FOUND);
+            if (!(nextEdgeEnd > searchRadius)) {
+              // Report this saddle connection (unless the search we continue
+              // has reported it already.)
+              return reportable();
+            } else {
+              // If the vertex is beyond the search radius, we do not report
+              // this new saddle connection. If additionaly, the other vertices
+              // of this triangle had already been outside of the search radius,
+              // we abort the search here.
+              if (baseExceedsSearchRadius()) {
+                // The other vertices of the triangle are outside of the search
+                // radius; abort the search here, i.e., backtrack.
+                moves.push_back(Move::GOTO_OTHER_FACE);
+                if (recordCrossings)
+                  path.pop_back();
+                recordSubsector();
+                state.pop();
+                STATISTICS(statistics.pruned++);
+                STATISTICS(depth--);
+              } else {
+                // One of the vertices is inside the search radius; continue the
+                // search.
+                moves.push_back(Move::GOTO_NEXT_EDGE);
+                recordConnection();
+              }
+              return false;
+            }
+        }
+        throw std::logic_error("impossible to happen");
+      case State::SADDLE_CONNECTION_FOUND:
+        // We have just reported a saddle connection; now we prepare
+        // the recursive descend into the clockwise sector.
+        tmp.push(boundary[1]);
+        applyMoves();
+        boundary[1] = nextEdgeEnd;
+        state.push(State::SADDLE_CONNECTION_FOUND_SEARCHING_SECOND);
+        state.push(State::START);
+        state.push(State::SADDLE_CONNECTION_FOUND_SEARCHING_FIRST);
+        state.push(State::START);
+        return false;
+      case State::SADDLE_CONNECTION_FOUND_SEARCHING_FIRST:
+        // We have just come back from the search in the clockwise sector; now
+        // we prepare the recursive descend into the counterclockwise sector.
+        boundary[1] = tmp.top();
+        tmp.pop();
+        tmp.push(boundary[0]);
+        applyMoves();
+        boundary[0] = nextEdgeEnd;
+        moves.push_back(Move::GOTO_NEXT_EDGE);
+        return false;
+      case State::SADDLE_CONNECTION_FOUND_SEARCHING_SECOND:
+        // We have just come back from the search in the counterclockwise
+        // sector; we are done here and return in the recursion.
+        boundary[0] = tmp.top();
+        tmp.pop();
+        break;
+      case State::OUTSIDE_SEARCH_SECTOR_COUNTERCLOCKWISE_SEARCHING:
+        moves.push_back(Move::GOTO_NEXT_EDGE);
+        break;
+      case State::OUTSIDE_SEARCH_SECTOR_CLOCKWISE_SEARCHING:
+        break;
+    }
+
+    moves.push_back(Move::GOTO_NEXT_EDGE);
+    moves.push_back(Move::GOTO_OTHER_FACE);
+    if (recordCrossings)
+      path.pop_back();
+    STATISTICS(depth--);
+    return false;
+  }
+
+  void skipSector(CCW sector) {
+    ASSERT_ARGUMENT(sector != CCW::COLLINEAR,
+                    "There is no such thing like a collinear sector.");
+
+    // The search is not going to be complete, so there is no frontier to
+    // record anymore.
+    frontier.reset();
+
+    if (state.top() == State::SADDLE_CONNECTION_FOUND) {
+      increment();
+
+      if (sector == CCW::CLOCKWISE) {
+        // Go directly to the second sector by skipping the recursive call,
+        // i.e., the START.
+        assert(state.top() == State::START);
+        state.pop();
+
+        assert(state.top() == State::SADDLE_CONNECTION_FOUND_SEARCHING_FIRST);
+      } else if (sector == CCW::COUNTERCLOCKWISE) {
+        assert(state.top() == State::START);
+        state.pop();
+
+        assert(state.top() == State::SADDLE_CONNECTION_FOUND_SEARCHING_FIRST);
+        state.pop();
+
+        assert(state.top() == State::START);
+        // Skip the second recursive call by dropping its START.
+        state.pop();
+
+        // And push the rest back on the stack unchanged.
+        state.push(State::SADDLE_CONNECTION_FOUND_SEARCHING_FIRST);
+        state.push(State::START);
+      }
+    } else if (state.top() == State::START && state.size() == 2) {
+      if (sector == CCW::CLOCKWISE) {
+        // We are in the initial state, the reported saddle connection is on
+        // the counterclockwise end of the search vector. If we skip the
+        // clockwise sector, then we skip everything.
+        state.pop();
+        assert(state.top() == State::END);
+      } else {
+        // We are skipping the counterclockwise sector anyway.
+        ;
+      }
+    } else {
+      throw std::logic_error(
+          "sectors can only be skipped when a saddle connection has been "
+          "reported");
+    }
+  }
+
+  // Return whether the search just found a saddle connection, i.e., whether
+  // we can split() here.
+  bool splittable() const {
+    return state.top() == State::SADDLE_CONNECTION_FOUND;
+  }
+
+  // Bring the search, which has just been prepared for the search in
+  // sectors[sector], into the state described by checkpoint, see
+  // checkpoint(), i.e., run the state machine until its stack is the one
+  // recorded there. A subsearch (a START and everything it pushes) leaves
+  // boundary, nextEdge and nextEdgeEnd as it found them, so we do not need
+  // to run the subsearches that had completed (or had been skipped) at that
+  // point but only the ones that were still running. This takes time
+  // proportional to the depth of the search.
+  void restore(const typename Iterator::Checkpoint& checkpoint) {
+    vector<State> target;
+    for (auto s : checkpoint.stack) {
+      CHECK_ARGUMENT(s <= static_cast<std::uint8_t>(State::END), "checkpoint does not describe an iterator of a search without coroutines");
+      target.push_back(static_cast<State>(s));
+    }
+
+    // The number of states at the bottom of the stack that agree with the
+    // target. Since the state machine only changes the top of the stack, the
+    // states below remain untouched until it pops down to them.
+    size_t agree = 0;
+    const auto extend = [&]() {
+      while (agree < state.size() && agree < target.size() && state[agree] == target[agree])
+        agree++;
+    };
+
+    extend();
+    while (agree != state.size() || agree != target.size()) {
+      CHECK_ARGUMENT(state.top() != State::END, "checkpoint does not describe an iterator of this search");
+
+      const size_t depth = state.size();
+      if (state.top() == State::START && !(agree >= depth - 1 && target.size() >= depth)) {
+        // The subsearch at the top had completed or had been skipped.
+        state.pop();
+      } else if (state.top() == State::SADDLE_CONNECTION_FOUND && target.size() > depth && target[depth] == State::SADDLE_CONNECTION_FOUND_SEARCHING_FIRST) {
+        // Only skipSector() puts these states next to each other.
+        skipSector(CCW::COUNTERCLOCKWISE);
+      } else {
+        increment();
+      }
+
+      agree = std::min(agree, depth - 1);
+      extend();
+    }
+  }
+
+  std::optional<HalfEdge> incrementWithCrossings() {
+    while (true) {
+      if (state.top() == State::START) {
+        applyMoves();
+        auto ret = nextEdge;
+        increment();
+        return ret;
+      } else if (state.top() == State::SADDLE_CONNECTION_FOUND) {
+        return {};
+      } else {
+        increment();
+      }
+    }
+  }
+#endif
+
+  // Split off the search in the counterclockwise subsector next to the saddle
+  // connection that was just found, i.e., the one at nextEdgeEnd. This search
+  // then only continues in the clockwise subsector.
+  Implementation split() {
+    assert(splittable());
+
+    applyMoves();
+    const HalfEdge next = surface->nextInFace(nextEdge);
+    Implementation counterclockwise(surface, searchRadius, sectors[sector], approximations, window, recordCrossings, lowerBound, nextEdgeEnd, boundary[1], next, Endpoint(nextEdgeEnd + next, nextEdgeEnd.approximation + approximate(next)), path, automorphisms);
+    skipSector(CCW::COUNTERCLOCKWISE);
+    return counterclockwise;
+  }
+
+  // A saddle connection or a subsector at the top of the search tree, see
+  // shard().
+  using Node = std::variant<typename Frontier::Connection, typename Frontier::Subsector>;
+
+  // Return the top of the search tree, i.e., for each sector the saddle
+  // connection that it starts with and the subsector beyond it, or, if this
+  // search continues another search, the frontier of that search.
+  vector<Node> roots() const {
+    vector<Node> roots;
+
+    if (previous) {
+      for (const auto& connection : previous->connections)
+        roots.push_back(connection);
+      for (const auto& subsector : previous->subsectors)
+        roots.push_back(subsector);
+      return roots;
+    }
+
+    // This is the same as what prepareSearch() does for each sector.
+    for (auto e : sectors) {
+      const Endpoint begin(AlongTriangulation(surface, vector<HalfEdge>{e}), approximate(e));
+      const HalfEdge next = surface->nextInFace(e);
+      const Endpoint end(begin + next, begin.approximation + approximate(next));
+      Implementation root(surface, searchRadius, e, approximations, window, recordCrossings, lowerBound, begin, end, next, end, {}, automorphisms);
+      if (window && !root.clip())
+        continue;
+      if (!root.boundary[1].clipped)
+        roots.push_back(typename Frontier::Connection{e, next, root.nextEdgeEnd, {}});
+      roots.push_back(typename Frontier::Subsector{e, {root.boundary[0], root.boundary[1]}, next, root.nextEdgeEnd, {}});
+    }
+    return roots;
+  }
+
+  // Return the saddle connection where the search in subsector branches for
+  // the first time followed by the clockwise and the counterclockwise
+  // subsector next to it, i.e., in the order in which the search visits
+  // them. Return nothing if the search ends before it branches.
+  vector<Node> branch(const typename Frontier::Subsector& subsector) const {
+    Implementation search(surface, searchRadius, subsector.sector, approximations, window, recordCrossings, lowerBound, subsector.boundary[0], subsector.boundary[1], subsector.nextEdge, subsector.nextEdgeEnd, subsector.path, automorphisms);
+
+    // Descend like the START of increment() does.
+    while (true) {
+      if (search.recordCrossings)
+        search.path.push_back(search.crossing());
+
+      const auto classification = search.descend();
+      if (classification == Classification::SADDLE_CONNECTION)
+        break;
+      if (classification == Classification::OUTSIDE_SEARCH_SECTOR_CLOCKWISE)
+        search.moves.push_back(Move::GOTO_NEXT_EDGE);
+    }
+
+    if (search.nextEdgeEnd > searchRadius) {
+      // If the other vertices of the triangle are outside of the search
+      // radius as well, the search ends here.
+      if (search.baseExceedsSearchRadius())
+        return {};
+      search.moves.push_back(Move::GOTO_NEXT_EDGE);
+      search.applyMoves();
+    }
+
+    const HalfEdge next = surface->nextInFace(search.nextEdge);
+    return {
+        typename Frontier::Connection{subsector.sector, search.nextEdge, search.nextEdgeEnd, search.path},
+        typename Frontier::Subsector{subsector.sector, {search.boundary[0], search.nextEdgeEnd}, search.nextEdge, search.nextEdgeEnd, search.path},
+        typename Frontier::Subsector{subsector.sector, {search.nextEdgeEnd, search.boundary[1]}, next, Endpoint(search.nextEdgeEnd + next, search.nextEdgeEnd.approximation + approximate(next)), search.path},
+    };
+  }
+
+  // Return an estimate for the number of saddle connections in the
+  // subsector, namely (up to a constant factor) the area of the part of the
+  // disk of radius searchRadius between its boundaries that lies beyond the
+  // line through nextEdge.
+  double weight(const typename Frontier::Subsector& subsector) const {
+    const auto approximate = [](const typename Surface::Vector& v) { return static_cast<std::complex<double>>(v); };
+
+    std::complex<double> boundary[2];
+    for (int side = 0; side < 2; side++)
+      boundary[side] = approximate(subsector.boundary[side].clipped ? window->rays[side] : static_cast<typename Surface::Vector>(subsector.boundary[side]));
+    const double angle = std::max(0., std::arg(boundary[1] / boundary[0]));
+
+    const std::complex<double> end = approximate(static_cast<typename Surface::Vector>(subsector.nextEdgeEnd));
+    const std::complex<double> edge = approximate(surface->fromEdge(subsector.nextEdge));
+    const double distance = std::abs((std::conj(edge) * end).imag()) / std::abs(edge);
+
+    const double radius = static_cast<double>(searchRadius.length());
+    return angle * std::max(0., radius * radius - distance * distance);
+  }
+
+  // The number of saddle connections that each saddle connection we find
+  // stands for, see automorphisms.
+  size_t images() const noexcept {
+    return automorphisms ? automorphisms->size() : 1;
+  }
+
+  // Return the saddle connection at nextEdgeEnd or, if image is set, its
+  // image under that automorphism.
+  std::unique_ptr<SaddleConnection<Surface>> connection(size_t image = 0) const {
+    if (image != 0)
+      return mapped(image, sectors[sector], nextEdge, path);
+    return std::make_unique<SaddleConnection<Surface>>(saddleConnection(surface, sectors[sector], nextEdge, nextEdgeEnd, recordCrossings ? std::optional(path) : std::nullopt));
+  }
+
+  // Return the saddle connection from source to target with the given
+  // vector. Unless the coordinates are machine integers, the exact vector is
+  // only computed when the saddle connection is asked for it, since this
+  // sums up the exact vectors of all the half edges the vector is made of.
+  static SaddleConnection<Surface> saddleConnection(const std::shared_ptr<const Surface>& surface, HalfEdge source, HalfEdge target, const AlongTriangulation& vector, std::optional<std::vector<HalfEdge>> crossings = {}) {
+    if constexpr (filtered)
+      // We only keep the coefficients of the vector, not the vector itself
+      // which registers its coefficients with the surface to be notified of
+      // flips. Therefore, the surface must not be flipped before the vector
+      // has been computed, see SaddleConnection::vector().
+      return SaddleConnection<Surface>(
+          surface, source, target, [surface, coefficients = vector.coefficients()]() {
+            auto ret = coefficients[0].second * surface->fromEdge(coefficients[0].first);
+            for (size_t i = 1; i < coefficients.size(); i++)
+              ret += coefficients[i].second * surface->fromEdge(coefficients[i].first);
+            return ret;
+          },
+          std::move(crossings));
+    else if (crossings)
+      return SaddleConnection<Surface>(surface, source, target, static_cast<typename Surface::Vector>(vector), *crossings);
+    else
+      return SaddleConnection<Surface>(surface, source, target, static_cast<typename Surface::Vector>(vector));
+  }
+
+  // Return the image of the saddle connection from source to target that
+  // crosses the half edges in crossings under the automorphism with the
+  // given index.
+  std::unique_ptr<SaddleConnection<Surface>> mapped(size_t image, HalfEdge source, HalfEdge target, const vector<HalfEdge>& crossings) const {
+    const auto& automorphism = (*automorphisms)[image];
+    vector<HalfEdge> mapped;
+    mapped.reserve(crossings.size());
+    for (auto crossing : crossings)
+      mapped.push_back(automorphism(crossing));
+    return std::unique_ptr<SaddleConnection<Surface>>(new SaddleConnection<Surface>(surface, automorphism(source), automorphism(target), develop(automorphism(source), mapped, automorphism(target)), mapped));
+  }
+
+  // Return the vector of the saddle connection leaving in the sector next to
+  // source that crosses the half edges in crossings and ends at the end of
+  // target. Since this only depends on the combinatorics of these half edges,
+  // we can determine the images of saddle connections under automorphisms
+  // with it, without knowing the rotation that the automorphism performs.
+  typename Surface::Vector develop(HalfEdge source, const vector<HalfEdge>& crossings, HalfEdge target) const {
+    // The half edge we cross next and the vector to its end.
+    HalfEdge current = surface->nextInFace(source);
+    typename Surface::Vector end = surface->fromEdge(source);
+    end += surface->fromEdge(current);
+
+    const auto cross = [&](const HalfEdge next) {
+      // We leave the triangle on the other side of current through one of
+      // its two other edges. Only the first of these changes the end.
+      if (next == surface->nextInFace(-current)) {
+        end -= surface->fromEdge(current);
+        end += surface->fromEdge(next);
+      } else {
+        assert(next == surface->nextInFace(surface->nextInFace(-current)));
+      }
+      current = next;
+    };
+
+    assert(crossings.empty() || crossings[0] == current);
+    for (size_t i = 1; i < crossings.size(); i++)
+      cross(crossings[i]);
+    if (crossings.size())
+      cross(target);
+    assert(current == target);
+
+    return end;
+  }
+
+  // Return the half edge that the search crosses next, i.e., nextEdge once
+  // the pending moves have been applied. Unlike applyMoves(), this does not
+  // touch nextEdgeEnd and is therefore cheap.
+  HalfEdge crossing() const {
+    HalfEdge e = nextEdge;
+    for (size_t i = 0; i < moves.size(); i++) {
+      switch (moves[i]) {
+        case Move::GOTO_NEXT_EDGE:
+          e = surface->nextInFace(e);
+          break;
+        case Move::GOTO_OTHER_FACE:
+          e = -e;
+          break;
+        case Move::GOTO_PREVIOUS_EDGE:
+          e = -surface->nextAtVertex(e);
+          break;
+      }
+    }
+    return e;
+  }
+
+  void apply(const Move m) {
+    switch (m) {
+      case Move::GOTO_NEXT_EDGE:
+        nextEdge = surface->nextInFace(nextEdge);
+        nextEdgeEnd += nextEdge;
+        if constexpr (filtered)
+          nextEdgeEnd.approximation += approximate(nextEdge);
+        break;
+      case Move::GOTO_OTHER_FACE:
+        nextEdge = -nextEdge;
+        nextEdgeEnd += nextEdge;
+        if constexpr (filtered)
+          nextEdgeEnd.approximation += approximate(nextEdge);
+        break;
+      case Move::GOTO_PREVIOUS_EDGE:
+        nextEdgeEnd -= nextEdge;
+        if constexpr (filtered)
+          nextEdgeEnd.approximation -= approximate(nextEdge);
+        nextEdge = surface->nextAtVertex(nextEdge);
+        nextEdge = -nextEdge;
+        break;
+    }
+  }
+
+  // Return the floating point approximation of the half edge e.
+  Approximation approximate(HalfEdge e) const {
+    if constexpr (filtered)
+      return (*approximations)[HalfEdgeMap<int>::index(e)];
+    else
+      return {};
+  }
+
+  // Return the orientation of rhs relative to lhs. Most of the time, the
+  // floating point approximations decide this so we do not need to consult
+  // Arb or exact arithmetic.
+  CCW ccw(const Endpoint& lhs, const Endpoint& rhs) const {
+    if constexpr (filtered) {
+      if (auto ccw = lhs.approximation.ccw(rhs.approximation)) {
+        STATISTICS(statistics.approximate++);
+        return *ccw;
+      }
+    }
+    STATISTICS(statistics.exact++);
+    return lhs.ccw(rhs);
+  }
+
+  // Return the orientation of v relative to boundary[side], or, if that
+  // boundary has been clipped, relative to the ray of the window replacing it.
+  CCW ccwBoundary(int side, const Endpoint& v) const {
+    if (boundary[side].clipped)
+      return ccwWindow(side, v);
+    return ccw(boundary[side], v);
+  }
+
+  // Return the orientation of v relative to the ray of the window at side.
+  CCW ccwWindow(int side, const Endpoint& v) const {
+    if constexpr (filtered) {
+      if (auto ccw = window->approximations[side].ccw(v.approximation)) {
+        STATISTICS(statistics.approximate++);
+        return *ccw;
+      }
+    }
+    STATISTICS(statistics.exact++);
+    return window->rays[side].ccw(static_cast<typename Surface::Vector>(v));
+  }
+
+  void applyMoves() {
+    // Moves count as collapsed unless they need to be applied individually.
+    STATISTICS(statistics.applyMoves++, statistics.moves += moves.size(), statistics.collapsed += moves.size());
+
+    if (moves.size() == 0) {
+      return;
+    }
+    while (moves.size()) {
+      const auto m = moves.front();
+      moves.pop_front();
+      if (moves.size() == 0) {
+        STATISTICS(statistics.collapsed--);
+        apply(m);
+        return;
+      }
+
+      const auto n = moves.front();
+      moves.pop_front();
+
+      switch (m) {
+        case Move::GOTO_NEXT_EDGE:
+          switch (n) {
+            case Move::GOTO_NEXT_EDGE:
+              moves.push_front(Move::GOTO_PREVIOUS_EDGE);
+              continue;
+            case Move::GOTO_PREVIOUS_EDGE:
+              continue;
+            case Move::GOTO_OTHER_FACE:
+              nextEdge = surface->nextInFace(nextEdge);
+              nextEdge = -nextEdge;
+              continue;
+          }
+        case Move::GOTO_PREVIOUS_EDGE:
+          switch (n) {
+            case Move::GOTO_NEXT_EDGE:
+              continue;
+            case Move::GOTO_PREVIOUS_EDGE:
+              moves.push_front(Move::GOTO_NEXT_EDGE);
+              continue;
+            case Move::GOTO_OTHER_FACE:
+              STATISTICS(statistics.collapsed--);
+              apply(Move::GOTO_NEXT_EDGE);
+              moves.push_front(Move::GOTO_OTHER_FACE);
+              moves.push_front(Move::GOTO_NEXT_EDGE);
+              continue;
+          }
+        case Move::GOTO_OTHER_FACE:
+          switch (n) {
+            case Move::GOTO_NEXT_EDGE:
+#pragma GCC diagnostic push
+#pragma GCC diagnostic ignored "-Wimplicit-fallthrough"
+              moves.push_front(Move::GOTO_PREVIOUS_EDGE);
+#pragma GCC diagnostic pop
+              // fallthrough to the next case intended here
+            case Move::GOTO_PREVIOUS_EDGE:
+              nextEdge = -nextEdge;
+              nextEdge = surface->nextAtVertex(nextEdge);
+              nextEdge = -nextEdge;
+              continue;
+            case Move::GOTO_OTHER_FACE:
+              continue;
+          }
+      }
+    }
+  }
+
+  Classification classifyHalfEdgeEnd() const {
+    switch (ccwBoundary(0, nextEdgeEnd)) {
+      case CCW::CLOCKWISE:
+      case CCW::COLLINEAR:
+        return Classification::OUTSIDE_SEARCH_SECTOR_CLOCKWISE;
+      case CCW::COUNTERCLOCKWISE:
+        switch (ccwBoundary(1, nextEdgeEnd)) {
+          case CCW::CLOCKWISE:
+            return Classification::SADDLE_CONNECTION;
+          case CCW::COUNTERCLOCKWISE:
+          case CCW::COLLINEAR:
+            return Classification::OUTSIDE_SEARCH_SECTOR_COUNTERCLOCKWISE;
+        }
+    }
+    throw std::logic_error("impossible to happen");
+  }
+
+  friend std::ostream& operator<<(std::ostream& os, const Implementation& self) {
+    if (self.sector == self.sectors.size()) {
+      return os << "Iterator(END)";
+    }
+    return os << "Iterator(sector = " << self.sectors[self.sector] << ", connection = " << self.nextEdgeEnd << ")";
+  }
+};
+}  // namespace flatsurf
+
+#endif
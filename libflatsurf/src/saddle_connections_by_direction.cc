@@ -0,0 +1,276 @@
+/**********************************************************************
+ *  This file is part of flatsurf.
+ *
+ *        Copyright (C) 2019 Julian Rüth
+ *
+ *  Flatsurf is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, either version 3 of the License, or
+ *  (at your option) any later version.
+ *
+ *  Flatsurf is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with flatsurf. If not, see <https://www.gnu.org/licenses/>.
+ *********************************************************************/
+
+#include <algorithm>
+#include <memory>
+
+#include "flatsurf/flat_triangulation.hpp"
+#include "flatsurf/saddle_connection.hpp"
+#include "flatsurf/saddle_connections_by_direction.hpp"
+#include "flatsurf/vector.hpp"
+
+#include "saddle_connections/exploration.ipp"
+
+namespace flatsurf {
+template <typename Surface>
+class SaddleConnectionsByDirection<Surface>::Implementation {
+ public:
+  Implementation(const std::shared_ptr<const Surface>& surface, Bound searchRadius) : surface(surface), searchRadius(searchRadius) {}
+
+  std::shared_ptr<const Surface> surface;
+  Bound searchRadius;
+};
+
+template <typename Surface>
+class SaddleConnectionsByDirection<Surface>::Iterator::Implementation : public Exploration<Surface, typename SaddleConnections<Surface>::Iterator::Implementation, typename SaddleConnectionsByDirection<Surface>::Iterator::Implementation> {
+  using Search = typename SaddleConnections<Surface>::Iterator::Implementation;
+  using Base = Exploration<Surface, Search, Implementation>;
+  using Endpoint = typename Base::Endpoint;
+  using Side = typename Base::Side;
+
+  // What we know about the direction of a vector to compare it to others
+  // quickly.
+  struct Direction {
+    // Whether the vector is in the upper half plane, see upper().
+    bool upper;
+    // The vector itself, once the approximations were not good enough to
+    // compare it to another vector, see before().
+    mutable std::optional<typename Surface::Vector> exact;
+  };
+
+  // A subsector that has not been explored yet: the part of the sector
+  // starting at source between the boundaries that lies beyond nextEdge.
+  struct Subsector {
+    HalfEdge source;
+    Endpoint boundary[2];
+    HalfEdge nextEdge;
+    Endpoint nextEdgeEnd;
+    // The directions of the boundaries.
+    Direction directions[2];
+    // Whether the subsector contains the direction (1, 0), so it must be
+    // explored before any other direction is reported.
+    bool wraps;
+  };
+
+  // A saddle connection that has been found but not been reported yet since
+  // the subsectors might contain some in an earlier direction.
+  struct Candidate {
+    HalfEdge source;
+    HalfEdge target;
+    Endpoint vector;
+    Direction direction;
+  };
+
+ public:
+  // Unless end is set, i.e., this iterator is at the end already.
+  Implementation(const std::shared_ptr<const Surface>& surface, Bound searchRadius, bool end = false) : Base(surface), searchRadius(searchRadius) {
+    if (end) return;
+
+    this->start();
+    increment();
+  }
+
+  // Advance to the saddle connection with the next direction, exploring
+  // subsectors until none of them can contain an earlier direction.
+  void increment() {
+    while (true) {
+      if (!candidates.empty() && (subsectors.empty() || !explore(subsectors.front(), candidates.front()))) {
+        std::pop_heap(candidates.begin(), candidates.end(), [&](const auto& lhs, const auto& rhs) { return before(rhs.vector, rhs.direction, lhs.vector, lhs.direction); });
+        current = std::move(candidates.back());
+        candidates.pop_back();
+        position++;
+        return;
+      }
+
+      if (subsectors.empty()) {
+        current.reset();
+        return;
+      }
+
+      std::pop_heap(subsectors.begin(), subsectors.end(), [&](const auto& lhs, const auto& rhs) { return explore(rhs, lhs); });
+      Subsector subsector = std::move(subsectors.back());
+      subsectors.pop_back();
+      expanding[0] = std::move(subsector.directions[0]);
+      expanding[1] = std::move(subsector.directions[1]);
+      this->expand(subsector.source, std::move(subsector.boundary[0]), std::move(subsector.boundary[1]), subsector.nextEdge, std::move(subsector.nextEdgeEnd));
+    }
+  }
+
+  // Queue the subsector between begin and end beyond nextEdge unless it lies
+  // beyond the search radius entirely.
+  void push(HalfEdge source, const Endpoint& begin, const Endpoint& end, HalfEdge nextEdge, const Endpoint& nextEdgeEnd, std::pair<Side, Side> sides) {
+    if (this->exceeds(this->distance(nextEdge, nextEdgeEnd), searchRadius))
+      return;
+
+    Direction directions[2] = {direction(begin, sides.first), direction(end, sides.second)};
+    const bool wraps = !before(begin, directions[0], end, directions[1]);
+    subsectors.push_back({source, {begin, end}, nextEdge, nextEdgeEnd, {std::move(directions[0]), std::move(directions[1])}, wraps});
+    std::push_heap(subsectors.begin(), subsectors.end(), [&](const auto& lhs, const auto& rhs) { return explore(rhs, lhs); });
+  }
+
+  // Record the saddle connection from source to target to be reported once
+  // there cannot be any in an earlier direction anymore.
+  void candidate(HalfEdge source, HalfEdge target, const Endpoint& connection) {
+    found = Direction{upper(connection), {}};
+
+    if (connection > searchRadius)
+      return;
+
+    candidates.push_back({source, target, connection, found});
+    std::push_heap(candidates.begin(), candidates.end(), [&](const auto& lhs, const auto& rhs) { return before(rhs.vector, rhs.direction, lhs.vector, lhs.direction); });
+  }
+
+  // Return the direction of a boundary of a subsector that is being pushed.
+  // Mostly, these are the boundaries of the subsector being expanded or the
+  // saddle connection found last, see Exploration::expand(), whose direction
+  // we know already.
+  Direction direction(const Endpoint& boundary, Side side) const {
+    switch (side) {
+      case Side::BEGIN:
+        return expanding[0];
+      case Side::END:
+        return expanding[1];
+      case Side::CONNECTION:
+        return found;
+      default:
+        return Direction{upper(boundary), {}};
+    }
+  }
+
+  // Return whether the subsector needs to be explored before reporting the
+  // candidate, i.e., whether it might contain a direction before it.
+  bool explore(const Subsector& subsector, const Candidate& candidate) const {
+    return subsector.wraps || before(subsector.boundary[0], subsector.directions[0], candidate.vector, candidate.direction);
+  }
+
+  // Return whether lhs needs to be explored before rhs.
+  bool explore(const Subsector& lhs, const Subsector& rhs) const {
+    if (rhs.wraps) return false;
+    return lhs.wraps || before(lhs.boundary[0], lhs.directions[0], rhs.boundary[0], rhs.directions[0]);
+  }
+
+  // Return whether the direction of lhs comes strictly before the direction
+  // of rhs when turning counterclockwise from (1, 0).
+  bool before(const Endpoint& lhs, const Direction& lhsDirection, const Endpoint& rhs, const Direction& rhsDirection) const {
+    if (lhsDirection.upper != rhsDirection.upper)
+      return lhsDirection.upper;
+    if constexpr (Search::filtered) {
+      if (auto ccw = lhs.approximation.ccw(rhs.approximation))
+        return *ccw == CCW::COUNTERCLOCKWISE;
+    }
+    // The directions that the approximations cannot tell apart mostly come
+    // from subsectors that share a boundary or from parallel saddle
+    // connections. Both get compared over and over again in the heap, so we
+    // cache their exact vectors.
+    if (!lhsDirection.exact) lhsDirection.exact = static_cast<typename Surface::Vector>(lhs);
+    if (!rhsDirection.exact) rhsDirection.exact = static_cast<typename Surface::Vector>(rhs);
+    return lhsDirection.exact->ccw(*rhsDirection.exact) == CCW::COUNTERCLOCKWISE;
+  }
+
+  // Return whether the direction of v is in [0, π), measuring angles
+  // counterclockwise from (1, 0).
+  bool upper(const Endpoint& v) const {
+    if constexpr (Search::filtered) {
+      if (v.approximation.y > v.approximation.error)
+        return true;
+      if (v.approximation.y < -v.approximation.error)
+        return false;
+    }
+    const typename Surface::Vector horizontal(1, 0);
+    const auto vector = static_cast<typename Surface::Vector>(v);
+    switch (horizontal.ccw(vector)) {
+      case CCW::COUNTERCLOCKWISE:
+        return true;
+      case CCW::CLOCKWISE:
+        return false;
+      default:
+        return horizontal.orientation(vector) == ORIENTATION::SAME;
+    }
+  }
+
+  Bound searchRadius;
+  // A heap of the subsectors that have not been explored yet.
+  vector<Subsector> subsectors;
+  // A heap of the saddle connections that have been found but not been
+  // reported yet.
+  vector<Candidate> candidates;
+  // The directions of the boundaries of the subsector being expanded and of
+  // the saddle connection found last, see direction().
+  Direction expanding[2];
+  Direction found;
+
+  // The saddle connection we are at, unless we are at the end.
+  std::optional<Candidate> current;
+  // The number of saddle connections reported so far.
+  size_t position = 0;
+};
+
+template <typename Surface>
+SaddleConnectionsByDirection<Surface>::SaddleConnectionsByDirection(const std::shared_ptr<const Surface>& surface, const Bound searchRadius)
+    : impl(spimpl::make_impl<Implementation>(surface, searchRadius)) {}
+
+template <typename Surface>
+typename SaddleConnectionsByDirection<Surface>::Iterator SaddleConnectionsByDirection<Surface>::begin() const {
+  return Iterator(spimpl::make_impl<typename Iterator::Implementation>(impl->surface, impl->searchRadius));
+}
+
+template <typename Surface>
+typename SaddleConnectionsByDirection<Surface>::Iterator SaddleConnectionsByDirection<Surface>::end() const {
+  return Iterator(spimpl::make_impl<typename Iterator::Implementation>(impl->surface, impl->searchRadius, true));
+}
+
+template <typename Surface>
+SaddleConnectionsByDirection<Surface>::Iterator::Iterator(spimpl::impl_ptr<Implementation>&& impl) : impl(std::move(impl)) {}
+
+template <typename Surface>
+void SaddleConnectionsByDirection<Surface>::Iterator::increment() {
+  impl->increment();
+}
+
+template <typename Surface>
+bool SaddleConnectionsByDirection<Surface>::Iterator::equal(const Iterator& other) const {
+  if (impl->surface != other.impl->surface || impl->searchRadius != other.impl->searchRadius || impl->current.has_value() != other.impl->current.has_value())
+    return false;
+  return !impl->current || impl->position == other.impl->position;
+}
+
+template <typename Surface>
+std::unique_ptr<SaddleConnection<Surface>> SaddleConnectionsByDirection<Surface>::Iterator::dereference() const {
+  if (!impl->current) {
+    throw std::out_of_range("iterator is at end()");
+  }
+  const auto& current = *impl->current;
+  return std::make_unique<SaddleConnection<Surface>>(SaddleConnections<Surface>::Iterator::Implementation::saddleConnection(impl->surface, current.source, current.target, current.vector));
+}
+}  // namespace flatsurf
+
+// Instantiations of templates so implementations are generated for the linker
+#include <e-antic/renfxx_fwd.h>
+#include <exact-real/integer_ring.hpp>
+#include <exact-real/number_field.hpp>
+#include <exact-real/rational_field.hpp>
+#include "flatsurf/forward.hpp"
+
+namespace flatsurf {
+template class SaddleConnectionsByDirection<FlatTriangulation<long long>>;
+template class SaddleConnectionsByDirection<FlatTriangulation<eantic::renf_elem_class>>;
+template class SaddleConnectionsByDirection<FlatTriangulation<exactreal::Element<exactreal::IntegerRing>>>;
+template class SaddleConnectionsByDirection<FlatTriangulation<exactreal::Element<exactreal::RationalField>>>;
+template class SaddleConnectionsByDirection<FlatTriangulation<exactreal::Element<exactreal::NumberField>>>;
+}  // namespace flatsurf
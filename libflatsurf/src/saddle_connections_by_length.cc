@@ -0,0 +1,204 @@
+/**********************************************************************
+ *  This file is part of flatsurf.
+ *
+ *        Copyright (C) 2019 Julian Rüth
+ *
+ *  Flatsurf is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, either version 3 of the License, or
+ *  (at your option) any later version.
+ *
+ *  Flatsurf is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with flatsurf. If not, see <https://www.gnu.org/licenses/>.
+ *********************************************************************/
+
+#include <algorithm>
+#include <intervalxt/length.hpp>
+#include <memory>
+
+#include "flatsurf/flat_triangulation.hpp"
+#include "flatsurf/saddle_connection.hpp"
+#include "flatsurf/saddle_connections_by_length.hpp"
+#include "flatsurf/vector.hpp"
+
+#include "saddle_connections/exploration.ipp"
+
+namespace flatsurf {
+template <typename Surface>
+class SaddleConnectionsByLength<Surface>::Implementation {
+ public:
+  Implementation(const std::shared_ptr<const Surface>& surface, std::optional<Bound> searchRadius) : surface(surface), searchRadius(std::move(searchRadius)) {}
+
+  std::shared_ptr<const Surface> surface;
+  std::optional<Bound> searchRadius;
+};
+
+template <typename Surface>
+class SaddleConnectionsByLength<Surface>::Iterator::Implementation : public Exploration<Surface, typename SaddleConnections<Surface>::Iterator::Implementation, typename SaddleConnectionsByLength<Surface>::Iterator::Implementation> {
+  using Base = Exploration<Surface, typename SaddleConnections<Surface>::Iterator::Implementation, Implementation>;
+  using Endpoint = typename Base::Endpoint;
+  using T = typename Surface::Vector::Coordinate;
+
+  // A subsector that has not been explored yet: the part of the sector
+  // starting at source between the boundaries that lies beyond nextEdge.
+  struct Subsector {
+    HalfEdge source;
+    Endpoint boundary[2];
+    HalfEdge nextEdge;
+    Endpoint nextEdgeEnd;
+    // A lower bound for the length of the saddle connections in this
+    // subsector, see distance().
+    double distance;
+
+    bool operator<(const Subsector& rhs) const noexcept {
+      // Order the heap so that the closest subsector comes first.
+      return distance > rhs.distance;
+    }
+  };
+
+  // A saddle connection that has been found but not been reported yet since
+  // there might be shorter ones in the subsectors.
+  struct Candidate {
+    T norm;
+    Approximation approximation;
+    HalfEdge source;
+    HalfEdge target;
+    typename Surface::Vector vector;
+
+    bool operator<(const Candidate& rhs) const {
+      // Order the heap so that the shortest candidate comes first.
+      return rhs.norm < norm;
+    }
+  };
+
+ public:
+  // Unless end is set, i.e., this iterator is at the end already.
+  Implementation(const std::shared_ptr<const Surface>& surface, std::optional<Bound> searchRadius, bool end = false) : Base(surface), searchRadius(std::move(searchRadius)) {
+    if (end) return;
+
+    this->start();
+    increment();
+  }
+
+  // Advance to the next shortest saddle connection, exploring subsectors
+  // until none of them can contain anything shorter.
+  void increment() {
+    while (true) {
+      if (!candidates.empty() && (subsectors.empty() || subsectors.front().distance > this->length(candidates.front().approximation))) {
+        std::pop_heap(candidates.begin(), candidates.end());
+        current = std::move(candidates.back());
+        candidates.pop_back();
+        position++;
+        return;
+      }
+
+      if (subsectors.empty()) {
+        current.reset();
+        return;
+      }
+
+      std::pop_heap(subsectors.begin(), subsectors.end());
+      Subsector subsector = std::move(subsectors.back());
+      subsectors.pop_back();
+      this->expand(subsector.source, std::move(subsector.boundary[0]), std::move(subsector.boundary[1]), subsector.nextEdge, std::move(subsector.nextEdgeEnd));
+    }
+  }
+
+  // Queue the subsector between begin and end beyond nextEdge unless it lies
+  // beyond the search radius entirely.
+  void push(HalfEdge source, const Endpoint& begin, const Endpoint& end, HalfEdge nextEdge, const Endpoint& nextEdgeEnd, std::pair<typename Base::Side, typename Base::Side>) {
+    const double distance = this->distance(nextEdge, nextEdgeEnd);
+    if (searchRadius && this->exceeds(distance, *searchRadius))
+      return;
+
+    subsectors.push_back({source, {begin, end}, nextEdge, nextEdgeEnd, distance});
+    std::push_heap(subsectors.begin(), subsectors.end());
+  }
+
+  // Record the saddle connection from source to target to be reported once
+  // there cannot be any shorter ones anymore.
+  void candidate(HalfEdge source, HalfEdge target, const Endpoint& connection) {
+    auto vector = static_cast<typename Surface::Vector>(connection);
+    if (searchRadius && vector > *searchRadius)
+      return;
+
+    T norm = vector * vector;
+    candidates.push_back({std::move(norm), this->approximate(connection), source, target, std::move(vector)});
+    std::push_heap(candidates.begin(), candidates.end());
+  }
+
+  std::optional<Bound> searchRadius;
+  // A heap of the subsectors that have not been explored yet.
+  vector<Subsector> subsectors;
+  // A heap of the saddle connections that have been found but not been
+  // reported yet.
+  vector<Candidate> candidates;
+
+  // The saddle connection we are at, unless we are at the end.
+  std::optional<Candidate> current;
+  // The number of saddle connections reported so far.
+  size_t position = 0;
+};
+
+template <typename Surface>
+SaddleConnectionsByLength<Surface>::SaddleConnectionsByLength(const std::shared_ptr<const Surface>& surface)
+    : impl(spimpl::make_impl<Implementation>(surface, std::nullopt)) {}
+
+template <typename Surface>
+SaddleConnectionsByLength<Surface>::SaddleConnectionsByLength(const std::shared_ptr<const Surface>& surface, const Bound searchRadius)
+    : impl(spimpl::make_impl<Implementation>(surface, searchRadius)) {}
+
+template <typename Surface>
+typename SaddleConnectionsByLength<Surface>::Iterator SaddleConnectionsByLength<Surface>::begin() const {
+  return Iterator(spimpl::make_impl<typename Iterator::Implementation>(impl->surface, impl->searchRadius));
+}
+
+template <typename Surface>
+typename SaddleConnectionsByLength<Surface>::Iterator SaddleConnectionsByLength<Surface>::end() const {
+  return Iterator(spimpl::make_impl<typename Iterator::Implementation>(impl->surface, impl->searchRadius, true));
+}
+
+template <typename Surface>
+SaddleConnectionsByLength<Surface>::Iterator::Iterator(spimpl::impl_ptr<Implementation>&& impl) : impl(std::move(impl)) {}
+
+template <typename Surface>
+void SaddleConnectionsByLength<Surface>::Iterator::increment() {
+  impl->increment();
+}
+
+template <typename Surface>
+bool SaddleConnectionsByLength<Surface>::Iterator::equal(const Iterator& other) const {
+  if (impl->surface != other.impl->surface || impl->searchRadius != other.impl->searchRadius || impl->current.has_value() != other.impl->current.has_value())
+    return false;
+  return !impl->current || impl->position == other.impl->position;
+}
+
+template <typename Surface>
+std::unique_ptr<SaddleConnection<Surface>> SaddleConnectionsByLength<Surface>::Iterator::dereference() const {
+  if (!impl->current) {
+    throw std::out_of_range("iterator is at end()");
+  }
+  const auto& current = *impl->current;
+  return std::unique_ptr<SaddleConnection<Surface>>(new SaddleConnection<Surface>(impl->surface, current.source, current.target, current.vector));
+}
+}  // namespace flatsurf
+
+// Instantiations of templates so implementations are generated for the linker
+#include <e-antic/renfxx_fwd.h>
+#include <exact-real/integer_ring.hpp>
+#include <exact-real/number_field.hpp>
+#include <exact-real/rational_field.hpp>
+#include "flatsurf/forward.hpp"
+
+namespace flatsurf {
+template class SaddleConnectionsByLength<FlatTriangulation<long long>>;
+template class SaddleConnectionsByLength<FlatTriangulation<eantic::renf_elem_class>>;
+template class SaddleConnectionsByLength<FlatTriangulation<exactreal::Element<exactreal::IntegerRing>>>;
+template class SaddleConnectionsByLength<FlatTriangulation<exactreal::Element<exactreal::RationalField>>>;
+template class SaddleConnectionsByLength<FlatTriangulation<exactreal::Element<exactreal::NumberField>>>;
+}  // namespace flatsurf
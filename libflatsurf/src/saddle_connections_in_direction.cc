@@ -0,0 +1,147 @@
+/**********************************************************************
+ *  This file is part of flatsurf.
+ *
+ *        Copyright (C) 2019 Julian Rüth
+ *
+ *  Flatsurf is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, either version 3 of the License, or
+ *  (at your option) any later version.
+ *
+ *  Flatsurf is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with flatsurf. If not, see <https://www.gnu.org/licenses/>.
+ *********************************************************************/
+
+#include <algorithm>
+#include <memory>
+
+#include "flatsurf/flat_triangulation.hpp"
+#include "flatsurf/saddle_connection.hpp"
+#include "flatsurf/saddle_connections_in_direction.hpp"
+#include "flatsurf/vector.hpp"
+
+#include "saddle_connections/exploration.ipp"
+
+namespace flatsurf {
+template <typename Surface>
+class SaddleConnectionsInDirection<Surface>::Implementation : public Exploration<Surface, typename SaddleConnections<Surface>::Iterator::Implementation, typename SaddleConnectionsInDirection<Surface>::Implementation> {
+  using Search = typename SaddleConnections<Surface>::Iterator::Implementation;
+  using Base = Exploration<Surface, Search, Implementation>;
+  using Endpoint = typename Base::Endpoint;
+
+ public:
+  Implementation(const std::shared_ptr<const Surface>& surface, const typename Surface::Vector& direction, Bound searchRadius, typename Search::Approximations approximations = nullptr) : Base(surface, std::move(approximations)), direction(direction), approximation(Search::Window::approximate(direction)), searchRadius(searchRadius) {
+    CHECK_ARGUMENT(direction, "direction must not be zero");
+
+    for (auto e : surface->halfEdges())
+      walk(e);
+  }
+
+  // Walk from the source of sectorBegin in direction across the surface
+  // until we hit a vertex, if direction is in the sector next to
+  // sectorBegin.
+  void walk(HalfEdge sectorBegin) {
+    auto& cursor = this->cursor;
+
+    const Endpoint begin(typename Search::AlongTriangulation(this->surface, vector<HalfEdge>{sectorBegin}), cursor.approximate(sectorBegin));
+    if (ccw(begin) != CCW::CLOCKWISE)
+      return;
+
+    cursor.nextEdge = this->surface->nextInFace(sectorBegin);
+    cursor.nextEdgeEnd = Endpoint(begin + cursor.nextEdge, begin.approximation + cursor.approximate(cursor.nextEdge));
+
+    // Since sectors are less than π wide, direction is in the sector iff it
+    // is not clockwise from the end of the sector.
+    CCW orientation = ccw(cursor.nextEdgeEnd);
+    if (orientation == CCW::CLOCKWISE)
+      return;
+
+    // We walk across nextEdge whose end is counterclockwise from direction
+    // and whose start is clockwise from direction, until its end is on our
+    // way.
+    while (orientation != CCW::COLLINEAR) {
+      if (this->exceeds(this->distance(cursor.nextEdge, cursor.nextEdgeEnd), searchRadius))
+        return;
+
+      cursor.moves.push_back(Move::GOTO_OTHER_FACE);
+      cursor.moves.push_back(Move::GOTO_NEXT_EDGE);
+      cursor.applyMoves();
+
+      orientation = ccw(cursor.nextEdgeEnd);
+      if (orientation == CCW::CLOCKWISE) {
+        // We leave the triangle through the other edge, whose end is the
+        // start of the edge we just crossed.
+        cursor.moves.push_back(Move::GOTO_NEXT_EDGE);
+        cursor.applyMoves();
+        orientation = CCW::COUNTERCLOCKWISE;
+      }
+    }
+
+    if (cursor.nextEdgeEnd > searchRadius)
+      return;
+
+    connections.push_back(Search::saddleConnection(this->surface, sectorBegin, cursor.nextEdge, cursor.nextEdgeEnd));
+  }
+
+  // Return the orientation of v relative to direction.
+  CCW ccw(const Endpoint& v) const {
+    if constexpr (Search::filtered) {
+      if (auto ccw = approximation.ccw(v.approximation))
+        return *ccw;
+    }
+    return direction.ccw(static_cast<typename Surface::Vector>(v));
+  }
+
+  typename Surface::Vector direction;
+  Approximation approximation;
+  Bound searchRadius;
+  vector<SaddleConnection<Surface>> connections;
+};
+
+template <typename Surface>
+SaddleConnectionsInDirection<Surface>::SaddleConnectionsInDirection(const std::shared_ptr<const Surface>& surface, const typename Surface::Vector& direction, const Bound searchRadius)
+    : impl(spimpl::make_impl<Implementation>(surface, direction, searchRadius)) {}
+
+template <typename Surface>
+SaddleConnectionsInDirection<Surface>::SaddleConnectionsInDirection(spimpl::impl_ptr<Implementation>&& impl) : impl(std::move(impl)) {}
+
+template <typename Surface>
+typename SaddleConnectionsInDirection<Surface>::Iterator SaddleConnectionsInDirection<Surface>::begin() const {
+  return impl->connections.begin();
+}
+
+template <typename Surface>
+typename SaddleConnectionsInDirection<Surface>::Iterator SaddleConnectionsInDirection<Surface>::end() const {
+  return impl->connections.end();
+}
+
+template <typename Surface>
+size_t SaddleConnectionsInDirection<Surface>::size() const {
+  return impl->connections.size();
+}
+
+template <typename Surface>
+SaddleConnectionsInDirection<Surface> SaddleConnectionsInDirection<Surface>::inDirection(const typename Surface::Vector& direction) const {
+  return SaddleConnectionsInDirection(spimpl::make_impl<Implementation>(impl->surface, direction, impl->searchRadius, impl->cursor.approximations));
+}
+}  // namespace flatsurf
+
+// Instantiations of templates so implementations are generated for the linker
+#include <e-antic/renfxx_fwd.h>
+#include <exact-real/integer_ring.hpp>
+#include <exact-real/number_field.hpp>
+#include <exact-real/rational_field.hpp>
+#include "flatsurf/forward.hpp"
+
+namespace flatsurf {
+template class SaddleConnectionsInDirection<FlatTriangulation<long long>>;
+template class SaddleConnectionsInDirection<FlatTriangulation<eantic::renf_elem_class>>;
+template class SaddleConnectionsInDirection<FlatTriangulation<exactreal::Element<exactreal::IntegerRing>>>;
+template class SaddleConnectionsInDirection<FlatTriangulation<exactreal::Element<exactreal::RationalField>>>;
+template class SaddleConnectionsInDirection<FlatTriangulation<exactreal::Element<exactreal::NumberField>>>;
+}  // namespace flatsurf
@@ -0,0 +1,75 @@
+/**********************************************************************
+ *  This file is part of flatsurf.
+ *
+ *        Copyright (C) 2019 Julian Rüth
+ *
+ *  Flatsurf is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, either version 3 of the License, or
+ *  (at your option) any later version.
+ *
+ *  Flatsurf is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with flatsurf. If not, see <https://www.gnu.org/licenses/>.
+ *********************************************************************/
+
+#include <intervalxt/length.hpp>
+
+#include "flatsurf/flat_triangulation.hpp"
+#include "flatsurf/saddle_connection.hpp"
+#include "flatsurf/saddle_connections_by_length.hpp"
+#include "flatsurf/shortest_saddle_connections.hpp"
+#include "flatsurf/vector.hpp"
+
+using std::vector;
+
+namespace flatsurf {
+template <typename Surface>
+class ShortestSaddleConnections<Surface>::Implementation {
+ public:
+  Implementation(const std::shared_ptr<const Surface>& surface, size_t k) {
+    auto connection = SaddleConnectionsByLength<Surface>(surface).begin();
+    for (; connections.size() != k; ++connection)
+      connections.push_back(**connection);
+  }
+
+  vector<SaddleConnection<Surface>> connections;
+};
+
+template <typename Surface>
+ShortestSaddleConnections<Surface>::ShortestSaddleConnections(const std::shared_ptr<const Surface>& surface, size_t k) : impl(spimpl::make_impl<Implementation>(surface, k)) {}
+
+template <typename Surface>
+typename ShortestSaddleConnections<Surface>::Iterator ShortestSaddleConnections<Surface>::begin() const {
+  return impl->connections.begin();
+}
+
+template <typename Surface>
+typename ShortestSaddleConnections<Surface>::Iterator ShortestSaddleConnections<Surface>::end() const {
+  return impl->connections.end();
+}
+
+template <typename Surface>
+size_t ShortestSaddleConnections<Surface>::size() const {
+  return impl->connections.size();
+}
+}  // namespace flatsurf
+
+// Instantiations of templates so implementations are generated for the linker
+#include <e-antic/renfxx_fwd.h>
+#include <exact-real/integer_ring.hpp>
+#include <exact-real/number_field.hpp>
+#include <exact-real/rational_field.hpp>
+#include "flatsurf/forward.hpp"
+
+namespace flatsurf {
+template class ShortestSaddleConnections<FlatTriangulation<long long>>;
+template class ShortestSaddleConnections<FlatTriangulation<eantic::renf_elem_class>>;
+template class ShortestSaddleConnections<FlatTriangulation<exactreal::Element<exactreal::IntegerRing>>>;
+template class ShortestSaddleConnections<FlatTriangulation<exactreal::Element<exactreal::RationalField>>>;
+template class ShortestSaddleConnections<FlatTriangulation<exactreal::Element<exactreal::NumberField>>>;
+}  // namespace flatsurf
@@ -0,0 +1,157 @@
+/**********************************************************************
+ *  This file is part of flatsurf.
+ *
+ *        Copyright (C) 2019 Julian Rüth
+ *
+ *  Flatsurf is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, either version 3 of the License, or
+ *  (at your option) any later version.
+ *
+ *  Flatsurf is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with flatsurf. If not, see <https://www.gnu.org/licenses/>.
+ *********************************************************************/
+
+#ifndef LIBFLATSURF_UTIL_CHECKED_ARITHMETIC_IPP
+#define LIBFLATSURF_UTIL_CHECKED_ARITHMETIC_IPP
+
+#include <gmpxx.h>
+#include <cassert>
+#include <climits>
+#include <cstdint>
+#include <exact-real/arb.hpp>
+#include <optional>
+#include <stdexcept>
+
+#include "assert.ipp"
+
+// Arithmetic on long long that cannot overflow and conversions between long
+// long and the GMP and Arb types that do not go through strings.
+//
+// Products of two long long are computed exactly with 128 bit integers. Only
+// when a sum of such products does not fit into 128 bits, i.e., for
+// coordinates close to 2^63, we promote to GMP integers.
+
+namespace flatsurf {
+namespace {
+namespace checked {
+
+// Return value as a GMP integer. (GMP only knows about long which might be
+// shorter than a long long.)
+inline mpz_class mpz(long long value) {
+  if constexpr (sizeof(long) >= sizeof(long long)) {
+    return mpz_class(static_cast<long>(value));
+  } else {
+    const bool negative = value < 0;
+    const std::uint64_t magnitude = negative ? -static_cast<std::uint64_t>(value) : static_cast<std::uint64_t>(value);
+    mpz_class ret;
+    mpz_import(ret.get_mpz_t(), 1, -1, sizeof(std::uint64_t), 0, 0, &magnitude);
+    return negative ? mpz_class(-ret) : ret;
+  }
+}
+
+// Return whether value can be represented as a long long.
+inline bool fits(const mpz_class& value) {
+  if constexpr (sizeof(long) >= sizeof(long long)) {
+    return mpz_fits_slong_p(value.get_mpz_t());
+  } else {
+    return mpz_sizeinbase(value.get_mpz_t(), 2) < 64 || value == mpz(LLONG_MIN);
+  }
+}
+
+// Return value, which must fit into a long long, see fits().
+inline long long toLongLong(const mpz_class& value) {
+  assert(fits(value) && "Value does not fit into a long long");
+  if constexpr (sizeof(long) >= sizeof(long long)) {
+    return mpz_get_si(value.get_mpz_t());
+  } else {
+    std::uint64_t magnitude = 0;
+    mpz_export(&magnitude, nullptr, -1, sizeof(std::uint64_t), 0, 0, value.get_mpz_t());
+    return ::sgn(value) < 0 ? static_cast<long long>(-magnitude) : static_cast<long long>(magnitude);
+  }
+}
+
+// Return value as an exact Arb.
+inline exactreal::Arb arb(long long value) {
+  if constexpr (sizeof(long) >= sizeof(long long)) {
+    exactreal::Arb ret;
+    arb_set_si(ret.arb_t(), static_cast<long>(value));
+    return ret;
+  } else {
+    return exactreal::Arb(mpz(value));
+  }
+}
+
+// Return a·b unless it does not fit into a long long.
+inline std::optional<long long> product(long long a, long long b) noexcept {
+  long long ret;
+  if (__builtin_mul_overflow(a, b, &ret))
+    return std::nullopt;
+  return ret;
+}
+
+#ifdef __SIZEOF_INT128__
+
+using Wide = __int128;
+
+inline mpz_class mpz(Wide value) {
+  const bool negative = value < 0;
+  const unsigned __int128 magnitude = negative ? -static_cast<unsigned __int128>(value) : static_cast<unsigned __int128>(value);
+  const std::uint64_t words[2] = {static_cast<std::uint64_t>(magnitude), static_cast<std::uint64_t>(magnitude >> 64)};
+  mpz_class ret;
+  mpz_import(ret.get_mpz_t(), 2, -1, sizeof(std::uint64_t), 0, 0, words);
+  return negative ? mpz_class(-ret) : ret;
+}
+
+inline Wide wide(long long a, long long b) noexcept {
+  return static_cast<Wide>(a) * b;
+}
+
+// Return the sign of a·b + c·d - e·f - g·h.
+inline int sgn(long long a, long long b, long long c, long long d, long long e = 0, long long f = 0, long long g = 0, long long h = 0) {
+  const Wide ab = wide(a, b);
+  const Wide cd = wide(c, d);
+  const Wide ef = wide(e, f);
+  const Wide gh = wide(g, h);
+
+  Wide lhs, rhs;
+  if (!__builtin_add_overflow(ab, cd, &lhs) && !__builtin_add_overflow(ef, gh, &rhs))
+    return (lhs > rhs) - (lhs < rhs);
+
+  return ::sgn(mpz(ab) + mpz(cd) - mpz(ef) - mpz(gh));
+}
+
+// Return a·b + c·d. Throws if the result does not fit into a long long.
+inline long long sum(long long a, long long b, long long c, long long d) {
+  Wide ret;
+  const bool overflow = __builtin_add_overflow(wide(a, b), wide(c, d), &ret);
+  CHECK_ARGUMENT(!overflow && ret >= LLONG_MIN && ret <= LLONG_MAX, "result does not fit into a long long");
+  return static_cast<long long>(ret);
+}
+
+#else
+
+// Return the sign of a·b + c·d - e·f - g·h.
+inline int sgn(long long a, long long b, long long c, long long d, long long e = 0, long long f = 0, long long g = 0, long long h = 0) {
+  return ::sgn(mpz(a) * mpz(b) + mpz(c) * mpz(d) - mpz(e) * mpz(f) - mpz(g) * mpz(h));
+}
+
+// Return a·b + c·d. Throws if the result does not fit into a long long.
+inline long long sum(long long a, long long b, long long c, long long d) {
+  const mpz_class ret = mpz(a) * mpz(b) + mpz(c) * mpz(d);
+  CHECK_ARGUMENT(fits(ret), "result does not fit into a long long");
+  return toLongLong(ret);
+}
+
+#endif
+
+}  // namespace checked
+}  // namespace
+}  // namespace flatsurf
+
+#endif
@@ -0,0 +1,171 @@
+/**********************************************************************
+ *  This file is part of flatsurf.
+ *
+ *        Copyright (C) 2019 Julian Rüth
+ *
+ *  Flatsurf is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, either version 3 of the License, or
+ *  (at your option) any later version.
+ *
+ *  Flatsurf is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with flatsurf. If not, see <https://www.gnu.org/licenses/>.
+ *********************************************************************/
+
+#ifndef LIBFLATSURF_UTIL_RECURSIVE_COROUTINE_IPP
+#define LIBFLATSURF_UTIL_RECURSIVE_COROUTINE_IPP
+
+#include <coroutine>
+#include <memory>
+#include <optional>
+#include <utility>
+#include <vector>
+
+namespace {
+// A C++20 coroutine that can co_await other coroutines of the same type and
+// co_yield events of type Event. Such a chain of coroutines behaves like a
+// recursive generator: a co_yield in the innermost coroutine suspends the
+// entire chain and hands the event to the caller of resume(). Coroutines
+// transfer control to each other directly, so deep recursion does not grow
+// the call stack, and their frames are recycled so recursion does not
+// allocate in steady state.
+template <typename Event>
+class RecursiveCoroutine {
+ public:
+  struct promise_type;
+  using Handle = std::coroutine_handle<promise_type>;
+
+ private:
+  // The state shared by all the coroutines of a chain.
+  struct Chain {
+    // The innermost coroutine that is running or suspended.
+    Handle leaf;
+    // The event that was yielded last.
+    std::optional<Event> event;
+  };
+
+  // Frames of coroutines that have been destroyed, by size, so we can reuse
+  // them for the next coroutine of that size.
+  struct FramePool {
+    ~FramePool() {
+      for (auto& frames : free)
+        for (void* frame : frames.second)
+          ::operator delete(frame);
+    }
+
+    std::vector<void*>& operator[](size_t size) {
+      for (auto& frames : free)
+        if (frames.first == size) return frames.second;
+      return free.emplace_back(size, std::vector<void*>{}).second;
+    }
+
+    std::vector<std::pair<size_t, std::vector<void*>>> free;
+  };
+
+  static FramePool& pool() {
+    thread_local FramePool pool;
+    return pool;
+  }
+
+ public:
+  struct promise_type {
+    RecursiveCoroutine get_return_object() noexcept { return RecursiveCoroutine(Handle::from_promise(*this)); }
+
+    std::suspend_always initial_suspend() const noexcept { return {}; }
+
+    auto final_suspend() const noexcept {
+      struct Return {
+        bool await_ready() const noexcept { return false; }
+        std::coroutine_handle<> await_suspend(Handle self) const noexcept {
+          // Continue in the coroutine that awaited this one, or return
+          // control to resume() if this was the outermost one.
+          auto& promise = self.promise();
+          promise.chain->leaf = promise.parent;
+          if (promise.parent) return promise.parent;
+          return std::noop_coroutine();
+        }
+        void await_resume() const noexcept {}
+      };
+      return Return{};
+    }
+
+    std::suspend_always yield_value(Event event) noexcept {
+      chain->event = event;
+      return {};
+    }
+
+    void return_void() const noexcept {}
+
+    void unhandled_exception() const { throw; }
+
+    static void* operator new(size_t size) {
+      auto& frames = pool()[size];
+      if (frames.empty()) return ::operator new(size);
+      void* frame = frames.back();
+      frames.pop_back();
+      return frame;
+    }
+
+    static void operator delete(void* frame, size_t size) {
+      pool()[size].push_back(frame);
+    }
+
+    Handle parent;
+    Chain* chain = nullptr;
+  };
+
+  RecursiveCoroutine(RecursiveCoroutine&& rhs) noexcept : handle(std::exchange(rhs.handle, {})), chain(std::move(rhs.chain)) {}
+  RecursiveCoroutine& operator=(RecursiveCoroutine&& rhs) noexcept {
+    reset();
+    handle = std::exchange(rhs.handle, {});
+    chain = std::move(rhs.chain);
+    return *this;
+  }
+
+  ~RecursiveCoroutine() { reset(); }
+
+  // Run the chain until an event is yielded anywhere in it. Return nothing if
+  // the chain ran to completion instead.
+  std::optional<Event> resume() {
+    if (!chain) {
+      chain = std::make_unique<Chain>();
+      chain->leaf = handle;
+      handle.promise().chain = chain.get();
+    }
+    chain->event.reset();
+    if (chain->leaf) chain->leaf.resume();
+    return chain->event;
+  }
+
+  // Run the awaited coroutine as part of the awaiting chain.
+  bool await_ready() const noexcept { return false; }
+  std::coroutine_handle<> await_suspend(Handle parent) noexcept {
+    auto& promise = handle.promise();
+    promise.parent = parent;
+    promise.chain = parent.promise().chain;
+    promise.chain->leaf = handle;
+    return handle;
+  }
+  void await_resume() const noexcept {}
+
+ private:
+  explicit RecursiveCoroutine(Handle handle) noexcept : handle(handle) {}
+
+  void reset() noexcept {
+    // Destroying a suspended frame also destroys the coroutines that it is
+    // awaiting since they are temporaries in that frame.
+    if (handle) handle.destroy();
+    handle = {};
+  }
+
+  Handle handle;
+  std::unique_ptr<Chain> chain;
+};
+}  // namespace
+
+#endif
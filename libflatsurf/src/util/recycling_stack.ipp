@@ -0,0 +1,80 @@
+/**********************************************************************
+ *  This file is part of flatsurf.
+ *
+ *        Copyright (C) 2019 Julian Rüth
+ *
+ *  Flatsurf is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, either version 3 of the License, or
+ *  (at your option) any later version.
+ *
+ *  Flatsurf is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with flatsurf. If not, see <https://www.gnu.org/licenses/>.
+ *********************************************************************/
+
+#ifndef LIBFLATSURF_UTIL_RECYCLING_STACK_IPP
+#define LIBFLATSURF_UTIL_RECYCLING_STACK_IPP
+
+#include <cassert>
+#include <utility>
+#include <vector>
+
+namespace {
+// A stack that keeps the elements that have been popped around, so that a
+// later push() can assign to an existing element instead of constructing a
+// new one. This is useful for elements that own resources which are
+// expensive to allocate but cheap to overwrite.
+template <typename T>
+class RecyclingStack {
+ public:
+  RecyclingStack() = default;
+  // A copy only contains the elements that are actually on the stack.
+  RecyclingStack(const RecyclingStack& rhs) : elements(rhs.elements.begin(), rhs.elements.begin() + rhs.depth), depth(rhs.depth) {}
+  RecyclingStack(RecyclingStack&& rhs) noexcept : elements(std::move(rhs.elements)), depth(std::exchange(rhs.depth, 0)) {}
+
+  bool empty() const noexcept { return depth == 0; }
+  size_t size() const noexcept { return depth; }
+
+  T& top() noexcept {
+    assert(depth != 0);
+    return elements[depth - 1];
+  }
+
+  const T& top() const noexcept {
+    assert(depth != 0);
+    return elements[depth - 1];
+  }
+
+  // Return the i-th element counting from the bottom of the stack.
+  const T& operator[](size_t i) const noexcept {
+    assert(i < depth);
+    return elements[i];
+  }
+
+  void push(const T& value) {
+    if (depth == elements.size())
+      elements.push_back(value);
+    else
+      elements[depth] = value;
+    depth++;
+  }
+
+  void pop() noexcept {
+    assert(depth != 0);
+    depth--;
+  }
+
+  void clear() noexcept { depth = 0; }
+
+ private:
+  std::vector<T> elements;
+  size_t depth = 0;
+};
+}  // namespace
+
+#endif
@@ -0,0 +1,104 @@
+/**********************************************************************
+ *  This file is part of flatsurf.
+ *
+ *        Copyright (C) 2019 Julian Rüth
+ *
+ *  Flatsurf is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, either version 3 of the License, or
+ *  (at your option) any later version.
+ *
+ *  Flatsurf is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with flatsurf. If not, see <https://www.gnu.org/licenses/>.
+ *********************************************************************/
+
+#ifndef LIBFLATSURF_UTIL_RING_BUFFER_IPP
+#define LIBFLATSURF_UTIL_RING_BUFFER_IPP
+
+#include <algorithm>
+#include <cassert>
+#include <utility>
+#include <vector>
+
+namespace {
+// A double-ended queue in a single contiguous buffer. The buffer grows when
+// needed but never shrinks, so a queue that is filled and drained over and
+// over again does not allocate once it has reached its maximum size (unlike
+// std::deque which releases and allocates blocks as it moves through memory.)
+template <typename T>
+class RingBuffer {
+ public:
+  bool empty() const noexcept { return count == 0; }
+  size_t size() const noexcept { return count; }
+
+  const T& front() const noexcept {
+    assert(count != 0);
+    return buffer[head];
+  }
+
+  const T& back() const noexcept {
+    assert(count != 0);
+    return buffer[(head + count - 1) & mask()];
+  }
+
+  const T& operator[](size_t i) const noexcept {
+    assert(i < count);
+    return buffer[(head + i) & mask()];
+  }
+
+  void push_back(const T& value) {
+    reserve(count + 1);
+    buffer[(head + count) & mask()] = value;
+    count++;
+  }
+
+  void push_front(const T& value) {
+    reserve(count + 1);
+    head = (head + mask()) & mask();
+    buffer[head] = value;
+    count++;
+  }
+
+  void pop_front() noexcept {
+    assert(count != 0);
+    head = (head + 1) & mask();
+    count--;
+  }
+
+  void pop_back() noexcept {
+    assert(count != 0);
+    count--;
+  }
+
+  void clear() noexcept {
+    head = 0;
+    count = 0;
+  }
+
+ private:
+  // The size of the buffer is always a power of two, so we can wrap around
+  // with a bit mask.
+  size_t mask() const noexcept { return buffer.size() - 1; }
+
+  void reserve(size_t size) {
+    if (size <= buffer.size()) return;
+
+    std::vector<T> grown(std::max<size_t>(8, 2 * buffer.size()));
+    for (size_t i = 0; i < count; i++)
+      grown[i] = std::move(buffer[(head + i) & mask()]);
+    buffer = std::move(grown);
+    head = 0;
+  }
+
+  std::vector<T> buffer;
+  size_t head = 0;
+  size_t count = 0;
+};
+}  // namespace
+
+#endif
@@ -0,0 +1,155 @@
+/**********************************************************************
+ *  This file is part of flatsurf.
+ *
+ *        Copyright (C) 2019 Julian Rüth
+ *
+ *  Flatsurf is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, either version 3 of the License, or
+ *  (at your option) any later version.
+ *
+ *  Flatsurf is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with flatsurf. If not, see <https://www.gnu.org/licenses/>.
+ *********************************************************************/
+
+#ifndef LIBFLATSURF_UTIL_WORK_STEALING_POOL_IPP
+#define LIBFLATSURF_UTIL_WORK_STEALING_POOL_IPP
+
+#include <atomic>
+#include <condition_variable>
+#include <deque>
+#include <exception>
+#include <mutex>
+#include <optional>
+#include <thread>
+#include <vector>
+
+namespace {
+// A minimal pool of threads that process tasks of type Task.
+// Each thread owns a queue of tasks. It works on the most recent task in its
+// own queue and, once that queue runs empty, steals the oldest task from the
+// queue of another thread. Tasks that run for a long time should check
+// hungry() every now and then and push() a part of their work to the pool so
+// other threads can pick it up.
+template <typename Task>
+class WorkStealingPool {
+ public:
+  explicit WorkStealingPool(size_t threads) : queues(threads) {}
+
+  size_t size() const noexcept { return queues.size(); }
+
+  // Return whether some thread is waiting for a task.
+  bool hungry() const noexcept { return idle.load(std::memory_order_relaxed) != 0; }
+
+  // Enqueue a task in the queue of the given thread.
+  void push(size_t thread, Task&& task) {
+    pending++;
+    {
+      std::lock_guard<std::mutex> lock(queues[thread].lock);
+      queues[thread].tasks.push_back(std::move(task));
+    }
+    queued++;
+
+    std::lock_guard<std::mutex> lock(sleeping);
+    wake.notify_one();
+  }
+
+  // Run worker(thread, task) on all the tasks in the pool (including the ones
+  // that are pushed while running) and return once all of them have been
+  // processed. If a worker throws, the remaining tasks are dropped and the
+  // exception is rethrown here.
+  template <typename Worker>
+  void run(const Worker& worker) {
+    std::vector<std::thread> threads;
+    for (size_t thread = 0; thread < size(); thread++)
+      threads.emplace_back([&, thread]() { work(thread, worker); });
+    for (auto& thread : threads)
+      thread.join();
+    if (error)
+      std::rethrow_exception(error);
+  }
+
+ private:
+  std::optional<Task> pop(size_t thread) {
+    for (size_t i = 0; i < size(); i++) {
+      auto& queue = queues[(thread + i) % size()];
+      std::lock_guard<std::mutex> lock(queue.lock);
+      if (queue.tasks.empty())
+        continue;
+      queued--;
+      std::optional<Task> task;
+      if (i == 0) {
+        task.emplace(std::move(queue.tasks.back()));
+        queue.tasks.pop_back();
+      } else {
+        task.emplace(std::move(queue.tasks.front()));
+        queue.tasks.pop_front();
+      }
+      return task;
+    }
+    return {};
+  }
+
+  template <typename Worker>
+  void work(size_t thread, const Worker& worker) {
+    while (true) {
+      auto task = pop(thread);
+      if (task) {
+        if (!failed) {
+          try {
+            worker(thread, std::move(*task));
+          } catch (...) {
+            std::lock_guard<std::mutex> lock(sleeping);
+            if (!error) error = std::current_exception();
+            failed = true;
+          }
+        }
+        task.reset();
+        if (--pending == 0) {
+          std::lock_guard<std::mutex> lock(sleeping);
+          wake.notify_all();
+        }
+        continue;
+      }
+
+      std::unique_lock<std::mutex> lock(sleeping);
+      // Since push() notifies while holding this lock, we can not miss a
+      // task that is pushed after we checked queued here.
+      if (queued != 0)
+        continue;
+      if (pending == 0)
+        return;
+      idle++;
+      wake.wait(lock);
+      idle--;
+    }
+  }
+
+  struct Queue {
+    std::mutex lock;
+    std::deque<Task> tasks;
+  };
+
+  std::vector<Queue> queues;
+
+  // The number of tasks that are queued or being processed.
+  std::atomic<size_t> pending = 0;
+  // The number of tasks that are queued.
+  std::atomic<size_t> queued = 0;
+  // The number of threads waiting for a task.
+  std::atomic<size_t> idle = 0;
+
+  std::mutex sleeping;
+  std::condition_variable wake;
+
+  std::atomic<bool> failed = false;
+  std::exception_ptr error;
+};
+}  // namespace
+
+#endif
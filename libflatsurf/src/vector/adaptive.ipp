@@ -0,0 +1,193 @@
+/**********************************************************************
+ *  This file is part of flatsurf.
+ *
+ *        Copyright (C) 2019 Julian Rüth
+ *
+ *  Flatsurf is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, either version 3 of the License, or
+ *  (at your option) any later version.
+ *
+ *  Flatsurf is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with flatsurf. If not, see <https://www.gnu.org/licenses/>.
+ *********************************************************************/
+
+#ifndef LIBFLATSURF_VECTOR_ADAPTIVE_IPP
+#define LIBFLATSURF_VECTOR_ADAPTIVE_IPP
+
+#include <e-antic/renfxx.h>
+#include <cassert>
+#include <cstddef>
+#include <exact-real/arb.hpp>
+#include <exact-real/yap/arb.hpp>
+#include <gmpxx.h>
+#include <intervalxt/length.hpp>
+#include <mutex>
+#include <optional>
+#include <type_traits>
+
+#include "flatsurf/ccw.hpp"
+#include "flatsurf/config.h"
+#include "flatsurf/forward.hpp"
+#include "flatsurf/orientation.hpp"
+#include "flatsurf/precision.hpp"
+
+#include "../util/checked_arithmetic.ipp"
+
+// Predicates in ball arithmetic that can be retried at increasing precision,
+// see maximumPrecision().
+//
+// Most predicates are decided by a single evaluation at
+// ARB_PRECISION_FAST. The ones that are not are usually either exactly
+// degenerate, e.g., two collinear vectors, or they are very close to being
+// degenerate. In the former case no precision is going to help, so we do not
+// want to spend too much time before falling back to exact arithmetic. In
+// the latter case, a few more bits of precision are much cheaper than exact
+// arithmetic in a number field.
+
+namespace flatsurf {
+namespace adaptive {
+// The number of precisions ARB_PRECISION_FAST·2^i that we try at most.
+constexpr std::size_t LEVELS = 16;
+
+// Record that a predicate has been decided at the given level; LEVELS
+// meaning exact arithmetic. Only defined when configured with
+// --enable-statistics, see precisionStatistics().
+void resolved(std::size_t level) noexcept;
+
+// Number fields refine the embedding of their generator lazily when their
+// elements are approximated or compared. Since all the elements of a field
+// share this embedding, this is not thread-safe. Therefore, we serialize
+// everything that might refine an embedding, i.e., approximations and exact
+// arithmetic, see SaddleConnections::parallel(). (There is a single lock for all fields.
+// This is rarely contended since most predicates are decided with the
+// approximations of the half edges at ARB_PRECISION_FAST.)
+std::recursive_mutex& refinement() noexcept;
+
+// Return f() which computes with coordinates in T, serialized with other
+// computations that might refine the embedding of a number field.
+template <typename T, typename F>
+auto exactly(F&& f) {
+  if constexpr (std::is_same_v<T, long long> || std::is_same_v<T, mpz_class> || std::is_same_v<T, mpq_class>) {
+    return f();
+  } else {
+    std::lock_guard<std::recursive_mutex> lock(refinement());
+    return f();
+  }
+}
+
+// Evaluate predicate(prec) at doubling precisions starting from
+// ARB_PRECISION_FAST until it returns something. Return nothing if the
+// predicate could not be decided up to maximumPrecision(), so the caller
+// has to fall back to exact arithmetic.
+template <typename Predicate>
+auto decide(Predicate&& predicate) -> std::invoke_result_t<Predicate, long> {
+  const long maximum = maximumPrecision();
+
+  long prec = exactreal::ARB_PRECISION_FAST;
+  for (std::size_t level = 0; level < LEVELS; level++, prec *= 2) {
+    if (level != 0 && prec > maximum)
+      break;
+
+    auto ret = predicate(prec);
+    if (ret) {
+#ifdef LIBFLATSURF_STATISTICS
+      resolved(level);
+#endif
+      return ret;
+    }
+  }
+
+#ifdef LIBFLATSURF_STATISTICS
+  resolved(LEVELS);
+#endif
+  return {};
+}
+
+// Return a ball containing value with roughly prec bits of precision.
+template <typename T>
+exactreal::Arb arb(const T& value, long prec) {
+  return exactly<T>([&]() {
+    if constexpr (std::is_same_v<T, eantic::renf_elem_class> || std::is_same_v<T, mpq_class>) {
+      return exactreal::Arb(value, prec);
+    } else {
+      return value.arb(prec);
+    }
+  });
+}
+
+// Return the orientation of (rx, ry) relative to (x, y), see Vector::ccw(),
+// if it can be decided with balls of precision prec.
+inline std::optional<CCW> ccw(const exactreal::Arb& x, const exactreal::Arb& y, const exactreal::Arb& rx, const exactreal::Arb& ry, long prec) noexcept {
+  const exactreal::Arb a = (x * ry)(prec);
+  const exactreal::Arb b = (rx * y)(prec);
+
+  bool overlaps = arb_overlaps(a.arb_t(), b.arb_t());
+  if (overlaps) {
+    if (arb_is_exact(a.arb_t()) && arb_is_exact(b.arb_t())) {
+      if (a.equal(b)) {
+        // a and b are identical single point sets
+        return CCW::COLLINEAR;
+      }
+    }
+    return {};
+  } else {
+    int cmp = arf_cmp(arb_midref(a.arb_t()), arb_midref(b.arb_t()));
+    assert(cmp != 0);
+    if (cmp < 0)
+      return CCW::CLOCKWISE;
+    else
+      return CCW::COUNTERCLOCKWISE;
+  }
+}
+
+// Return the orientation of (rx, ry) relative to (x, y), see
+// Vector::orientation(), if it can be decided with balls of precision prec.
+inline std::optional<ORIENTATION> orientation(const exactreal::Arb& x, const exactreal::Arb& y, const exactreal::Arb& rx, const exactreal::Arb& ry, long prec) noexcept {
+  // Arb also has a built-in dot product. It's probably not doing anything else in 2d.
+  const exactreal::Arb dot = (x * rx + y * ry)(prec);
+
+  auto cmp = dot > 0;
+  if (cmp.has_value()) {
+    if (*cmp) {
+      return ORIENTATION::SAME;
+    } else {
+      auto is_zero = dot == exactreal::Arb();
+      if (is_zero.has_value() && *is_zero) {
+        // dot is the single point 0 without any ball imprecision
+        return ORIENTATION::ORTHOGONAL;
+      } else {
+        return ORIENTATION::OPPOSITE;
+      }
+    }
+  }
+  return {};
+}
+
+// Return whether x² + y² < bound² if it can be decided with balls of
+// precision prec.
+inline std::optional<bool> lt(const exactreal::Arb& x, const exactreal::Arb& y, Bound bound, long prec) noexcept {
+  const exactreal::Arb length = checked::arb(bound.length());
+  const exactreal::Arb size = (x * x + y * y)(prec);
+  const exactreal::Arb squared = (length * length)(prec);
+  return size < squared;
+}
+
+// Return whether x² + y² > bound² if it can be decided with balls of
+// precision prec.
+inline std::optional<bool> gt(const exactreal::Arb& x, const exactreal::Arb& y, Bound bound, long prec) noexcept {
+  const exactreal::Arb length = checked::arb(bound.length());
+  const exactreal::Arb size = (x * x + y * y)(prec);
+  const exactreal::Arb squared = (length * length)(prec);
+  return size > squared;
+}
+
+}  // namespace adaptive
+}  // namespace flatsurf
+
+#endif
@@ -55,12 +55,12 @@ static constexpr bool has_eq = is_detected_exact_v<bool, eq_t, Implementation>;
 template <typename Implementation>
 using ccw_t = decltype(std::declval<Implementation>().ccw(std::declval<const typename Implementation::Vector&>()));
 template <typename Implementation>
-static constexpr bool has_ccw = is_detected_exact_v<bool, ccw_t, Implementation>;
+static constexpr bool has_ccw = is_detected_exact_v<CCW, ccw_t, Implementation>;
 
 template <typename Implementation>
 using orientation_t = decltype(std::declval<Implementation>().orientation(std::declval<const typename Implementation::Vector&>()));
 template <typename Implementation>
-static constexpr bool has_orientation = is_detected_exact_v<bool, orientation_t, Implementation>;
+static constexpr bool has_orientation = is_detected_exact_v<ORIENTATION, orientation_t, Implementation>;
 
 template <typename Implementation>
 using x_t = decltype(std::declval<const Implementation&>().x());
@@ -23,6 +23,7 @@
 #include <intervalxt/length.hpp>
 #include <optional>
 
+#include "../adaptive.ipp"
 #include "../storage/cartesian.ipp"
 #include "../storage/forward.ipp"
 
@@ -50,9 +51,9 @@ VectorExact<Vector, T>::operator bool() const noexcept {
     auto maybe = static_cast<optional<bool>>(self.impl->approximation());
     if (maybe)
       return *maybe;
-    return static_cast<bool>(static_cast<const typename Implementation::Exact>(*self.impl));
+    return adaptive::exactly<T>([&]() { return static_cast<bool>(static_cast<const typename Implementation::Exact>(*self.impl)); });
   } else {
-    return self.x() || self.y();
+    return adaptive::exactly<T>([&]() { return self.x() || self.y(); });
   }
 }
 
@@ -66,12 +67,15 @@ bool VectorExact<Vector, T>::operator<(Bound bound) const noexcept {
   } else if constexpr (is_forward_v<Implementation>) {
     return self.impl->vector < bound;
   } else if constexpr (has_approximation_v<Implementation>) {
-    auto maybe = static_cast<optional<bool>>(self.impl->approximation() < bound);
+    auto maybe = adaptive::decide([&](long prec) {
+      const auto approximation = self.impl->approximation(prec);
+      return adaptive::lt(approximation.x(), approximation.y(), bound, prec);
+    });
     if (maybe)
       return *maybe;
-    return static_cast<const typename Implementation::Exact>(*self.impl) < bound;
+    return adaptive::exactly<T>([&]() { return static_cast<const typename Implementation::Exact>(*self.impl) < bound; });
   } else {
-    return self.x() * self.x() + self.y() * self.y() < bound.length() * bound.length();
+    return adaptive::exactly<T>([&]() { return self.x() * self.x() + self.y() * self.y() < bound.length() * bound.length(); });
   }
 }
 
@@ -85,12 +89,15 @@ bool VectorExact<Vector, T>::operator>(Bound bound) const noexcept {
   } else if constexpr (is_forward_v<Implementation>) {
     return self.impl->vector > bound;
   } else if constexpr (has_approximation_v<Implementation>) {
-    auto maybe = static_cast<optional<bool>>(self.impl->approximation() > bound);
+    auto maybe = adaptive::decide([&](long prec) {
+      const auto approximation = self.impl->approximation(prec);
+      return adaptive::gt(approximation.x(), approximation.y(), bound, prec);
+    });
     if (maybe)
       return *maybe;
-    return static_cast<const typename Implementation::Exact>(*self.impl) > bound;
+    return adaptive::exactly<T>([&]() { return static_cast<const typename Implementation::Exact>(*self.impl) > bound; });
   } else {
-    return self.x() * self.x() + self.y() * self.y() > bound.length() * bound.length();
+    return adaptive::exactly<T>([&]() { return self.x() * self.x() + self.y() * self.y() > bound.length() * bound.length(); });
   }
 }
 
@@ -107,9 +114,9 @@ bool VectorExact<Vector, T>::operator==(const Vector& rhs) const noexcept {
     auto maybe = static_cast<optional<bool>>(self.impl->approximation() == rhs.impl->approximation());
     if (maybe)
       return *maybe;
-    return static_cast<const typename Implementation::Exact>(*self.impl) == static_cast<const typename Implementation::Exact>(*rhs.impl);
+    return adaptive::exactly<T>([&]() { return static_cast<const typename Implementation::Exact>(*self.impl) == static_cast<const typename Implementation::Exact>(*rhs.impl); });
   } else {
-    return self.x() == rhs.x() && self.y() == rhs.y();
+    return adaptive::exactly<T>([&]() { return self.x() == rhs.x() && self.y() == rhs.y(); });
   }
 }
 
@@ -119,14 +126,18 @@ CCW VectorExact<Vector, T>::ccw(const Vector& rhs) const noexcept {
   const Vector& self = static_cast<const Vector&>(*this);
 
   if constexpr (has_ccw<Implementation>) {
-    return self.impl->ccw(*rhs.impl);
+    return self.impl->ccw(rhs);
   } else if constexpr (is_forward_v<Implementation>) {
     return self.impl->vector.ccw(rhs.impl->vector);
   } else if constexpr (has_approximation_v<Implementation>) {
-    auto maybe = self.impl->approximation().ccw(rhs.impl->approximation());
+    auto maybe = adaptive::decide([&](long prec) {
+      const auto lhs = self.impl->approximation(prec);
+      const auto other = rhs.impl->approximation(prec);
+      return adaptive::ccw(lhs.x(), lhs.y(), other.x(), other.y(), prec);
+    });
     if (maybe)
       return *maybe;
-    return static_cast<const typename Implementation::Exact>(*self.impl).ccw(static_cast<const typename Implementation::Exact>(*rhs.impl));
+    return adaptive::exactly<T>([&]() { return static_cast<const typename Implementation::Exact>(*self.impl).ccw(static_cast<const typename Implementation::Exact>(*rhs.impl)); });
   } else {
     // An alternative algorithm (somewhere in the git history) might be much
     // faster: Try to decide with the approximations. If they are not clear,
@@ -135,16 +146,18 @@ CCW VectorExact<Vector, T>::ccw(const Vector& rhs) const noexcept {
     // Presumably, all of this could happen automagically with yap just by
     // looking at the predicate sgn(x*y - x'*y').
 
-    const auto a = self.x() * rhs.y();
-    const auto b = rhs.x() * self.y();
-
-    if (a > b) {
-      return CCW::COUNTERCLOCKWISE;
-    } else if (a < b) {
-      return CCW::CLOCKWISE;
-    } else {
-      return CCW::COLLINEAR;
-    }
+    return adaptive::exactly<T>([&]() {
+      const auto a = self.x() * rhs.y();
+      const auto b = rhs.x() * self.y();
+
+      if (a > b) {
+        return CCW::COUNTERCLOCKWISE;
+      } else if (a < b) {
+        return CCW::CLOCKWISE;
+      } else {
+        return CCW::COLLINEAR;
+      }
+    });
   }
 }
 
@@ -186,14 +199,18 @@ ORIENTATION VectorExact<Vector, T>::orientation(const Vector& rhs) const noexcep
   const Vector& self = static_cast<const Vector&>(*this);
 
   if constexpr (has_orientation<Implementation>) {
-    return self.impl->orientation(*rhs.impl);
+    return self.impl->orientation(rhs);
   } else if constexpr (is_forward_v<Implementation>) {
     return self.impl->vector.orientation(rhs.impl->vector);
   } else if constexpr (has_approximation_v<Implementation>) {
-    auto maybe = self.impl->approximation().orientation(rhs.impl->approximation());
+    auto maybe = adaptive::decide([&](long prec) {
+      const auto lhs = self.impl->approximation(prec);
+      const auto other = rhs.impl->approximation(prec);
+      return adaptive::orientation(lhs.x(), lhs.y(), other.x(), other.y(), prec);
+    });
     if (maybe)
       return *maybe;
-    return static_cast<const typename Implementation::Exact>(*self.impl).orientation(static_cast<const typename Implementation::Exact>(*rhs.impl));
+    return adaptive::exactly<T>([&]() { return static_cast<const typename Implementation::Exact>(*self.impl).orientation(static_cast<const typename Implementation::Exact>(*rhs.impl)); });
   } else {
     // An alternative algorithm (somewhere in the git history) might be much
     // faster: Try to decide with the approximations. If they are not clear,
@@ -201,20 +218,22 @@ ORIENTATION VectorExact<Vector, T>::orientation(const Vector& rhs) const noexcep
     // increase precision until the approximations are good enough to decide.
     // Presumably, all of this could happen automagically with yap just by
     // looking at the predicate sgn(x*x' + y*y').
-    const auto dot = self.x() * rhs.x() + self.y() * rhs.y();
-
-    if (dot > 0) {
-      return ORIENTATION::SAME;
-    } else if (dot < 0) {
-      return ORIENTATION::OPPOSITE;
-    } else {
-      return ORIENTATION::ORTHOGONAL;
-    }
+    return adaptive::exactly<T>([&]() {
+      const auto dot = self.x() * rhs.x() + self.y() * rhs.y();
+
+      if (dot > 0) {
+        return ORIENTATION::SAME;
+      } else if (dot < 0) {
+        return ORIENTATION::OPPOSITE;
+      } else {
+        return ORIENTATION::ORTHOGONAL;
+      }
+    });
   }
 }
 
 template <typename Vector, typename T>
-T VectorExact<Vector, T>::operator*(const Vector& rhs) const noexcept {
+T VectorExact<Vector, T>::operator*(const Vector& rhs) const {
   using Implementation = typename Vector::Implementation;
   const Vector& self = static_cast<const Vector&>(*this);
 
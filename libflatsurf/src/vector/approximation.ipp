@@ -0,0 +1,109 @@
+/**********************************************************************
+ *  This file is part of flatsurf.
+ *
+ *        Copyright (C) 2019 Julian Rüth
+ *
+ *  Flatsurf is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, either version 3 of the License, or
+ *  (at your option) any later version.
+ *
+ *  Flatsurf is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with flatsurf. If not, see <https://www.gnu.org/licenses/>.
+ *********************************************************************/
+
+#ifndef LIBFLATSURF_VECTOR_APPROXIMATION_IPP
+#define LIBFLATSURF_VECTOR_APPROXIMATION_IPP
+
+#include <algorithm>
+#include <cmath>
+#include <exact-real/arb.hpp>
+#include <limits>
+#include <optional>
+
+#include "flatsurf/ccw.hpp"
+#include "flatsurf/vector.hpp"
+
+namespace flatsurf {
+namespace {
+// A floating point approximation of a vector in ℝ² with a certified error,
+// i.e., the exact coordinates differ by at most error from x and y.
+// Predicates on such approximations are much cheaper than Arb or exact
+// arithmetic and decide most questions already. When they cannot, they
+// return nothing and callers fall back to a more expensive method.
+struct Approximation {
+  // The unit roundoff of double.
+  static constexpr double u = std::numeric_limits<double>::epsilon() / 2;
+  // A factor that accounts for the rounding when computing error terms.
+  static constexpr double safety = 1 + 8 * u;
+  // A bound for absolute errors that come from underflow.
+  static constexpr double tiny = 16 * std::numeric_limits<double>::min();
+
+  Approximation() = default;
+
+  explicit Approximation(const Vector<exactreal::Arb>& vector) {
+    double ex, ey;
+    x = approximate(vector.x(), ex);
+    y = approximate(vector.y(), ey);
+    error = std::max(ex, ey);
+  }
+
+  Approximation& operator+=(const Approximation& rhs) noexcept {
+    x += rhs.x;
+    y += rhs.y;
+    error = (error + rhs.error + u * std::max(std::abs(x), std::abs(y)) + tiny) * safety;
+    return *this;
+  }
+
+  Approximation& operator-=(const Approximation& rhs) noexcept {
+    x -= rhs.x;
+    y -= rhs.y;
+    error = (error + rhs.error + u * std::max(std::abs(x), std::abs(y)) + tiny) * safety;
+    return *this;
+  }
+
+  friend Approximation operator+(Approximation lhs, const Approximation& rhs) noexcept {
+    return lhs += rhs;
+  }
+
+  // Return the orientation of rhs relative to this vector (as in
+  // Vector::ccw()) if the approximations are good enough to decide it.
+  std::optional<CCW> ccw(const Approximation& rhs) const noexcept {
+    const double p = x * rhs.y;
+    const double q = rhs.x * y;
+    const double det = p - q;
+
+    // The error coming from the errors of the coordinates…
+    double bound = error * (std::abs(rhs.x) + std::abs(rhs.y)) + rhs.error * (std::abs(x) + std::abs(y)) + 2 * error * rhs.error;
+    // …and the error of evaluating det in floating point arithmetic.
+    bound += 4 * u * (std::abs(p) + std::abs(q));
+    bound = (bound + tiny) * safety;
+
+    if (det > bound)
+      return CCW::COUNTERCLOCKWISE;
+    if (det < -bound)
+      return CCW::CLOCKWISE;
+    return {};
+  }
+
+  double x = 0;
+  double y = 0;
+  double error = 0;
+
+ private:
+  static double approximate(const exactreal::Arb& value, double& error) {
+    const double ret = arf_get_d(arb_midref(value.arb_t()), ARF_RND_NEAR);
+    // The radius of the ball plus the error of rounding its midpoint.
+    error = (mag_get_d(arb_radref(value.arb_t())) + u * std::abs(ret) + tiny) * safety;
+    return ret;
+  }
+};
+}  // namespace
+}  // namespace flatsurf
+
+#endif
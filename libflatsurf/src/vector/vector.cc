@@ -17,7 +17,6 @@
  *  along with flatsurf. If not, see <https://www.gnu.org/licenses/>.
  *********************************************************************/
 
-#include <boost/lexical_cast.hpp>
 #include <exact-real/element.hpp>
 #include <exact-real/integer_ring.hpp>
 #include <exact-real/number_field.hpp>
@@ -27,11 +26,12 @@
 #include "flatsurf/vector.hpp"
 
 #include "../util/assert.ipp"
+#include "../util/checked_arithmetic.ipp"
+#include "adaptive.ipp"
 #include "algorithm/exact.ipp"
 #include "algorithm/with_error.ipp"
 #include "storage/cartesian.ipp"
 
-using boost::lexical_cast;
 
 // We currently use this precision for all computations involving Arb.
 // This is somewhat random and should probably change, see
@@ -78,6 +78,13 @@ class Vector<T>::Implementation : public Cartesian<T> {
     return Vector(x, y);
   }
 
+  static typename Vector::Storage storage(const T& x, const T& y) {
+    if constexpr (std::is_same_v<typename Vector::Storage, spimpl::impl_ptr<Implementation>>)
+      return spimpl::make_impl<Implementation>(x, y);
+    else
+      return typename Vector::Storage(std::in_place, x, y);
+  }
+
   template <bool Enable = IsArb<T>, If<Enable> = true>
   Implementation& operator+=(const flatsurf::Vector<Arb>& rhs) {
     this->x += rhs.impl->x(ARB_PRECISION_FAST);
@@ -94,79 +101,75 @@ class Vector<T>::Implementation : public Cartesian<T> {
 
   template <typename S, bool Enable = IsLongLong<T>&& IsMPZ<S>, If<Enable> = true, typename = void>
   Implementation& operator*=(const S& rhs) {
-    assert(rhs * mpz_class(lexical_cast<std::string>(this->x)) <= mpz_class(lexical_cast<std::string>(LONG_LONG_MAX)) && "Multiplication overflow");
-    assert(rhs * mpz_class(lexical_cast<std::string>(this->y)) <= mpz_class(lexical_cast<std::string>(LONG_LONG_MAX)) && "Multiplication overflow");
-    this->x *= lexical_cast<long long>(lexical_cast<std::string>(rhs));
-    this->y *= lexical_cast<long long>(lexical_cast<std::string>(rhs));
+    CHECK_ARGUMENT(checked::fits(rhs), "Multiplication overflow");
+    const long long c = checked::toLongLong(rhs);
+    const auto x = checked::product(this->x, c);
+    const auto y = checked::product(this->y, c);
+    CHECK_ARGUMENT(x && y, "Multiplication overflow");
+    this->x = *x;
+    this->y = *y;
     return *this;
   }
 
   template <bool Enable = IsArb<T>, If<Enable> = true>
   std::optional<CCW> ccw(const flatsurf::Vector<exactreal::Arb>& rhs) const noexcept {
-    const Arb a = (this->x * rhs.impl->y)(ARB_PRECISION_FAST);
-    const Arb b = (rhs.impl->x * this->y)(ARB_PRECISION_FAST);
-
-    bool overlaps = arb_overlaps(a.arb_t(), b.arb_t());
-    if (overlaps) {
-      if (arb_is_exact(a.arb_t()) && arb_is_exact(b.arb_t())) {
-        if (a.equal(b)) {
-          // a and b are identical single point sets
-          return CCW::COLLINEAR;
-        }
-      }
-      return {};
-    } else {
-      int cmp = arf_cmp(arb_midref(a.arb_t()), arb_midref(b.arb_t()));
-      assert(cmp != 0);
-      if (cmp < 0)
-        return CCW::CLOCKWISE;
-      else
-        return CCW::COUNTERCLOCKWISE;
-    }
+    return adaptive::ccw(this->x, this->y, rhs.impl->x, rhs.impl->y, ARB_PRECISION_FAST);
+  }
+
+  // The predicates on long long coordinates square the coordinates, so we
+  // need to be careful not to overflow, see checked_arithmetic.ipp.
+  template <bool Enable = IsLongLong<T>, If<Enable> = true>
+  CCW ccw(const Vector& rhs) const noexcept {
+    const int sgn = checked::sgn(this->x, rhs.impl->y, 0, 0, rhs.impl->x, this->y);
+    return sgn > 0 ? CCW::COUNTERCLOCKWISE : sgn < 0 ? CCW::CLOCKWISE : CCW::COLLINEAR;
+  }
+
+  template <bool Enable = IsLongLong<T>, If<Enable> = true>
+  ORIENTATION orientation(const Vector& rhs) const noexcept {
+    const int sgn = checked::sgn(this->x, rhs.impl->x, this->y, rhs.impl->y);
+    return sgn > 0 ? ORIENTATION::SAME : sgn < 0 ? ORIENTATION::OPPOSITE : ORIENTATION::ORTHOGONAL;
+  }
+
+  template <bool Enable = IsLongLong<T>, If<Enable> = true, typename = void, typename = void>
+  bool operator<(const Bound bound) const noexcept {
+    return checked::sgn(this->x, this->x, this->y, this->y, bound.length(), bound.length()) < 0;
+  }
+
+  template <bool Enable = IsLongLong<T>, If<Enable> = true, typename = void, typename = void>
+  bool operator>(const Bound bound) const noexcept {
+    return checked::sgn(this->x, this->x, this->y, this->y, bound.length(), bound.length()) > 0;
+  }
+
+  template <bool Enable = IsLongLong<T>, If<Enable> = true, typename = void>
+  long long operator*(const Vector& rhs) const {
+    return checked::sum(this->x, rhs.impl->x, this->y, rhs.impl->y);
   }
 
   template <bool Enable = IsArb<T>, If<Enable> = true>
   std::optional<ORIENTATION> orientation(const flatsurf::Vector<exactreal::Arb>& rhs) const noexcept {
-    // Arb also has a built-in dot product. It's probably not doing anything else in 2d.
-    const Arb dot = (this->x * rhs.impl->x + this->y * rhs.impl->y)(ARB_PRECISION_FAST);
-
-    auto cmp = dot > 0;
-    if (cmp.has_value()) {
-      if (*cmp) {
-        return ORIENTATION::SAME;
-      } else {
-        auto is_zero = dot == Arb();
-        if (is_zero.has_value() && *is_zero) {
-          // dot is the single point 0 without any ball imprecision
-          return ORIENTATION::ORTHOGONAL;
-        } else {
-          return ORIENTATION::OPPOSITE;
-        }
-      }
-    }
-    return {};
+    return adaptive::orientation(this->x, this->y, rhs.impl->x, rhs.impl->y, ARB_PRECISION_FAST);
   }
 
   template <bool Enable = IsArb<T>, If<Enable> = true>
   std::optional<bool> operator<(const Bound bound) const noexcept {
-    Arb size = (this->x * this->x + this->y * this->y)(ARB_PRECISION_FAST);
-    return size < bound.squared();
+    return adaptive::lt(this->x, this->y, bound, ARB_PRECISION_FAST);
   }
 
   template <bool Enable = IsMPZ<T> || IsMPQ<T>, If<Enable> = true, typename = void>
   bool operator<(const Bound bound) const noexcept {
-    return this->x * this->x + this->y * this->y < mpz_class(boost::lexical_cast<std::string>(bound.squared()));
+    const mpz_class length = checked::mpz(bound.length());
+    return this->x * this->x + this->y * this->y < length * length;
   }
 
   template <bool Enable = IsArb<T>, If<Enable> = true>
   std::optional<bool> operator>(const Bound bound) const noexcept {
-    Arb size = (this->x * this->x + this->y * this->y)(ARB_PRECISION_FAST);
-    return size > bound.squared();
+    return adaptive::gt(this->x, this->y, bound, ARB_PRECISION_FAST);
   }
 
   template <bool Enable = IsMPZ<T> || IsMPQ<T>, If<Enable> = true, typename = void>
   bool operator>(const Bound bound) const noexcept {
-    return this->x * this->x + this->y * this->y > mpz_class(boost::lexical_cast<std::string>(bound.squared()));
+    const mpz_class length = checked::mpz(bound.length());
+    return this->x * this->x + this->y * this->y > length * length;
   }
 
   template <bool Enable = IsArb<T>, If<Enable> = true>
@@ -195,20 +198,44 @@ class Vector<T>::Implementation : public Cartesian<T> {
 
   template <bool Enable = IsEAntic<T> || IsMPQ<T>, If<Enable> = true>
   operator flatsurf::Vector<exactreal::Arb>() const noexcept {
-    return flatsurf::Vector<exactreal::Arb>(Arb(this->x, ARB_PRECISION_FAST), Arb(this->y, ARB_PRECISION_FAST));
+    return flatsurf::Vector<exactreal::Arb>(adaptive::arb(this->x, ARB_PRECISION_FAST), adaptive::arb(this->y, ARB_PRECISION_FAST));
   }
 
   template <bool Enable = IsExactReal<T>, If<Enable> = true, typename = void>
   operator flatsurf::Vector<exactreal::Arb>() const noexcept {
-    return flatsurf::Vector<exactreal::Arb>(this->x.arb(ARB_PRECISION_FAST), this->y.arb(ARB_PRECISION_FAST));
+    return flatsurf::Vector<exactreal::Arb>(adaptive::arb(this->x, ARB_PRECISION_FAST), adaptive::arb(this->y, ARB_PRECISION_FAST));
   }
 };
 
 template <typename T>
-Vector<T>::Vector() : impl(spimpl::make_impl<Implementation>(T(), T())) {}
+Vector<T>::Vector() : impl(Implementation::storage(T(), T())) {}
+
+template <typename T>
+Vector<T>::Vector(const T& x, const T& y) : impl(Implementation::storage(x, y)) {}
+
+template <typename T>
+Vector<T>::Vector(const Vector<T>& rhs) : impl(rhs.impl) {}
+
+template <typename T>
+Vector<T>::Vector(Vector<T>&& rhs) noexcept : impl(std::move(rhs.impl)) {}
+
+template <typename T>
+Vector<T>::~Vector() {}
+
+template <typename T>
+Vector<T>& Vector<T>::operator=(const Vector<T>& rhs) {
+  if (impl && rhs.impl)
+    *impl = *rhs.impl;
+  else
+    impl = rhs.impl;
+  return *this;
+}
 
 template <typename T>
-Vector<T>::Vector(const T& x, const T& y) : impl(spimpl::make_impl<Implementation>(x, y)) {}
+Vector<T>& Vector<T>::operator=(Vector<T>&& rhs) noexcept {
+  impl = std::move(rhs.impl);
+  return *this;
+}
 
 template <typename T>
 typename Vector<T>::Coordinate Vector<T>::x() const noexcept { return impl->x; }
@@ -17,7 +17,11 @@
  *  along with flatsurf. If not, see <https://www.gnu.org/licenses/>.
  *********************************************************************/
 
+#include <optional>
 #include <ostream>
+#include <stdexcept>
+#include <utility>
+#include <vector>
 
 #include "flatsurf/flat_triangulation.hpp"
 #include "flatsurf/flat_triangulation_combinatorial.hpp"
@@ -26,6 +30,7 @@
 #include "flatsurf/vector.hpp"
 #include "flatsurf/vector_along_triangulation.hpp"
 
+#include "vector/adaptive.ipp"
 #include "vector/algorithm/exact.ipp"
 #include "vector/storage/forward.ipp"
 
@@ -46,18 +51,70 @@ class SharedImplementation {
 
 template <typename Vector, typename Implementation, typename Approximation>
 class ImplementationWithApproximation : SharedImplementation<Vector, Implementation> {
+  // Return the two half edges whose sum was halfEdge before it was flipped.
+  // (If the faces were (e a b)(-e c d) before the flip of e, they are
+  // (a -e d)(c e b) afterwards, and e was c + d.)
+  static std::pair<HalfEdge, HalfEdge> beforeFlip(HalfEdge halfEdge, const FlatTriangulationCombinatorial& parent) {
+    return {parent.nextInFace(parent.nextInFace(halfEdge)), parent.nextInFace(-halfEdge)};
+  }
+
   static void updateAfterFlip(HalfEdgeMap<int>& map, HalfEdge halfEdge, const FlatTriangulationCombinatorial& parent) {
-    map.set(-parent.nextAtVertex(halfEdge), map.get(halfEdge));
-    map.set(-parent.nextInFace(parent.nextInFace(halfEdge)), map.get(halfEdge));
+    const int c = map.get(halfEdge);
+    const auto [a, b] = beforeFlip(halfEdge, parent);
+    map.set(a, map.get(a) + c);
+    map.set(b, map.get(b) + c);
     map.set(halfEdge, 0);
   }
 
+  // Return the handler that updates coefficients after a flip and rewrites
+  // the pending half edges in terms of the new triangulation. Like the
+  // former, this only depends on the combinatorics of the flip, so it does
+  // not matter whether the vectors of the surface have been updated yet.
+  typename HalfEdgeMap<int>::FlipHandler flipHandler() {
+    return [this](HalfEdgeMap<int>& map, HalfEdge halfEdge, const FlatTriangulationCombinatorial& parent) {
+      updateAfterFlip(map, halfEdge, parent);
+
+      const auto [a, b] = beforeFlip(halfEdge, parent);
+      const size_t size = pending.size();
+      for (size_t i = 0; i < size; i++) {
+        const auto [e, c] = pending[i];
+        if (e == halfEdge) {
+          pending[i].first = a;
+          pending.emplace_back(b, c);
+        } else if (e == -halfEdge) {
+          pending[i].first = -a;
+          pending.emplace_back(-b, c);
+        }
+      }
+    };
+  }
+
  public:
   using Exact = flatsurf::Vector<typename Vector::Coordinate>;
   using Shared = SharedImplementation<Vector, Implementation>;
   using Surface = typename Shared::Surface;
 
-  ImplementationWithApproximation(const std::shared_ptr<const Surface>& surface) : Shared(surface), coefficients(surface.get(), updateAfterFlip), approx(surface) {}
+  ImplementationWithApproximation(const std::shared_ptr<const Surface>& surface) : Shared(surface), coefficients(surface.get(), flipHandler()), approx(surface) {}
+
+  // The flip handler of coefficients refers to this object, so copies need
+  // their own coefficients with their own handler.
+  ImplementationWithApproximation(const ImplementationWithApproximation& rhs) : Shared(rhs), coefficients(rhs.surface.get(), flipHandler()), approx(rhs.approx), cache(rhs.cache), pending(rhs.pending) {
+    for (auto e : this->surface->halfEdges())
+      coefficients.set(e, rhs.coefficients.get(e));
+  }
+
+  ImplementationWithApproximation& operator=(const ImplementationWithApproximation& rhs) {
+    if (this->surface != rhs.surface) {
+      this->surface = rhs.surface;
+      coefficients = HalfEdgeMap<int>(this->surface.get(), flipHandler());
+    }
+    for (auto e : this->surface->halfEdges())
+      coefficients.set(e, rhs.coefficients.get(e));
+    approx = rhs.approx;
+    cache = rhs.cache;
+    pending = rhs.pending;
+    return *this;
+  }
 
   Vector operator-() const {
     Vector ret(this->surface);
@@ -66,29 +123,59 @@ class ImplementationWithApproximation : SharedImplementation<Vector, Implementat
   }
 
   operator Exact() const {
-    using WithoutApproximation = flatsurf::VectorAlongTriangulation<typename Exact::Coordinate>;
-    return static_cast<Exact>(WithoutApproximation(this->surface, coefficients));
+    return exact();
   }
 
   auto x() const {
-    return static_cast<Exact>(*this).x();
+    return exact().x();
   }
 
   auto y() const {
-    return static_cast<Exact>(*this).y();
+    return exact().y();
   }
 
   auto approximation() const {
     return static_cast<flatsurf::Vector<Approximation>>(approx);
   }
 
+  // Return an approximation of this vector with balls of (roughly) prec
+  // bits. Unlike approximation(), this is not maintained as the vector
+  // changes but computed from scratch for prec > ARB_PRECISION_FAST.
+  flatsurf::Vector<Approximation> approximation(long prec) const {
+    if (prec <= exactreal::ARB_PRECISION_FAST)
+      return approximation();
+
+    Approximation x, y;
+    for (auto e : this->surface->halfEdges()) {
+      const int c = coefficients.get(e);
+      if (c > 0) {
+        const auto& v = this->surface->fromEdge(e);
+        x = (x + Approximation(c) * adaptive::arb(v.x(), prec))(prec);
+        y = (y + Approximation(c) * adaptive::arb(v.y(), prec))(prec);
+      }
+    }
+    return flatsurf::Vector<Approximation>(x, y);
+  }
+
   auto operator*(const Vector& rhs) const noexcept {
-    return static_cast<Exact>(*this) * static_cast<Exact>(rhs);
+    return exact() * Implementation::impl(rhs).exact();
+  }
+
+  std::vector<std::pair<HalfEdge, int>> nonzeroCoefficients() const {
+    std::vector<std::pair<HalfEdge, int>> ret;
+    for (auto e : this->surface->halfEdges()) {
+      const int c = coefficients.get(e);
+      if (c > 0)
+        ret.emplace_back(e, c);
+    }
+    return ret;
   }
 
   auto& operator+=(const HalfEdge e) {
     coefficients.set(e, coefficients.get(e) + 1);
     approx += e;
+    if (cache)
+      pending.emplace_back(e, 1);
     return *this;
   }
 
@@ -98,18 +185,42 @@ class ImplementationWithApproximation : SharedImplementation<Vector, Implementat
       int c = coefficients.get(e);
       if (c > 0) {
         this->coefficients.set(e, this->coefficients.get(e) + c);
+        if (cache)
+          pending.emplace_back(e, c);
       }
     }
     return *this;
   }
 
+  // Return the exact vector. It is computed from the coefficients on first
+  // use. Later, only the half edges added since the previous call are
+  // applied to it. (Like the approximation, this is not thread-safe.)
+  const Exact& exact() const {
+    if (!cache) {
+      using WithoutApproximation = flatsurf::VectorAlongTriangulation<typename Exact::Coordinate>;
+      cache = static_cast<Exact>(WithoutApproximation(this->surface, coefficients));
+    } else {
+      for (const auto& [e, c] : pending) {
+        if (c == 1)
+          *cache += this->surface->fromEdge(e);
+        else
+          *cache += c * this->surface->fromEdge(e);
+      }
+    }
+    pending.clear();
+    return *cache;
+  }
+
  private:
   HalfEdgeMap<int> coefficients;
   flatsurf::VectorAlongTriangulation<Approximation, void, Surface> approx;
 
-  // We could also keep the exact vector around until it changes or buffer the
-  // changes in another HalfEdgeMap and only apply these to the exact vector
-  // when it's cheaper.
+  // The exact vector as of the last call to exact() and the half edges that
+  // have been added since (with multiplicities.) Like coefficients, the
+  // latter is updated when edges are flipped so it still describes the same
+  // vector.
+  mutable std::optional<Exact> cache;
+  mutable std::vector<std::pair<HalfEdge, int>> pending;
 };
 
 template <typename Vector, typename Implementation, typename T>
@@ -136,8 +247,7 @@ class ImplementationWithForward : public Forward<flatsurf::Vector<T>>, SharedImp
   }
 
   auto& operator+=(const HalfEdge e) {
-    // The following cast is usually trivial, but may not be when Surface != FlatTriangulation<T>.
-    this->vector += static_cast<flatsurf::Vector<T>>(this->surface->fromEdge(e));
+    this->vector += fromEdge(e);
     return *this;
   }
 
@@ -145,7 +255,7 @@ class ImplementationWithForward : public Forward<flatsurf::Vector<T>>, SharedImp
     for (auto e : this->surface->halfEdges()) {
       int c = coefficients.get(e);
       if (c > 0) {
-        this->vector += c * static_cast<flatsurf::Vector<T>>(this->surface->fromEdge(e));
+        this->vector += c * fromEdge(e);
       }
     }
     return *this;
@@ -154,6 +264,19 @@ class ImplementationWithForward : public Forward<flatsurf::Vector<T>>, SharedImp
   operator flatsurf::Vector<T>() const {
     return this->vector;
   }
+
+ private:
+  // Return the vector of e with coordinates in T. This is usually trivial,
+  // but may not be when Surface != FlatTriangulation<T>.
+  decltype(auto) fromEdge(const HalfEdge e) const {
+    if constexpr (std::is_same_v<flatsurf::Vector<T>, typename Surface::Vector>) {
+      return this->surface->fromEdge(e);
+    } else if constexpr (std::is_same_v<T, exactreal::Arb>) {
+      return this->surface->fromEdgeApproximate(e);
+    } else {
+      return static_cast<flatsurf::Vector<T>>(this->surface->fromEdge(e));
+    }
+  }
 };
 }  // namespace
 
@@ -179,11 +302,40 @@ VectorAlongTriangulation<T, Approximation, Surface>::VectorAlongTriangulation(co
   *this += coefficients;
 }
 
+template <typename T, typename Approximation, typename Surface>
+VectorAlongTriangulation<T, Approximation, Surface>::VectorAlongTriangulation(const VectorAlongTriangulation& rhs) : impl(rhs.impl) {}
+
+template <typename T, typename Approximation, typename Surface>
+VectorAlongTriangulation<T, Approximation, Surface>::VectorAlongTriangulation(VectorAlongTriangulation&& rhs) noexcept : impl(std::move(rhs.impl)) {}
+
+template <typename T, typename Approximation, typename Surface>
+VectorAlongTriangulation<T, Approximation, Surface>& VectorAlongTriangulation<T, Approximation, Surface>::operator=(const VectorAlongTriangulation& rhs) {
+  if (impl && rhs.impl)
+    *impl = *rhs.impl;
+  else
+    impl = rhs.impl;
+  return *this;
+}
+
+template <typename T, typename Approximation, typename Surface>
+VectorAlongTriangulation<T, Approximation, Surface>& VectorAlongTriangulation<T, Approximation, Surface>::operator=(VectorAlongTriangulation&& rhs) noexcept {
+  impl = std::move(rhs.impl);
+  return *this;
+}
+
 template <typename T, typename Approximation, typename Surface>
 VectorAlongTriangulation<T, Approximation, Surface>::operator Vector<T>() const noexcept {
   return static_cast<Vector<T>>(*this->impl);
 }
 
+template <typename T, typename Approximation, typename Surface>
+std::vector<std::pair<HalfEdge, int>> VectorAlongTriangulation<T, Approximation, Surface>::coefficients() const {
+  if constexpr (std::is_same_v<Approximation, void>)
+    throw std::logic_error("vector does not keep track of its coefficients");
+  else
+    return impl->nonzeroCoefficients();
+}
+
 template <typename T, typename Approximation, typename Surface>
 VectorAlongTriangulation<T, Approximation, Surface>::VectorAlongTriangulation(const std::shared_ptr<const Surface>& surface, const std::vector<HalfEdge>& edges) : VectorAlongTriangulation(surface) {
   for (auto edge : edges)
@@ -246,7 +398,7 @@ extern template ORIENTATION VectorExact<Vector<long long>, long long>::orientati
 template class VectorAlongTriangulation<long long>;
 extern template long long VectorExact<Vector<long long>, long long>::x() const noexcept;
 extern template long long VectorExact<Vector<long long>, long long>::y() const noexcept;
-extern template long long VectorExact<Vector<long long>, long long>::operator*(const Vector<long long>&)const noexcept;
+extern template long long VectorExact<Vector<long long>, long long>::operator*(const Vector<long long>&) const;
 extern template bool VectorExact<Vector<long long>, long long>::operator==(const Vector<long long>&) const noexcept;
 template class detail::VectorExact<VectorAlongTriangulation<long long>, long long>;
 extern template Vector<long long>& VectorBase<Vector<long long>>::operator+=(const Vector<long long>&);
@@ -270,7 +422,7 @@ extern template ORIENTATION VectorExact<Vector<renf_elem_class>, renf_elem_class
 template class VectorAlongTriangulation<renf_elem_class>;
 extern template renf_elem_class VectorExact<Vector<renf_elem_class>, renf_elem_class>::x() const noexcept;
 extern template renf_elem_class VectorExact<Vector<renf_elem_class>, renf_elem_class>::y() const noexcept;
-extern template renf_elem_class VectorExact<Vector<renf_elem_class>, renf_elem_class>::operator*(const Vector<renf_elem_class>&)const noexcept;
+extern template renf_elem_class VectorExact<Vector<renf_elem_class>, renf_elem_class>::operator*(const Vector<renf_elem_class>&) const;
 extern template bool VectorExact<Vector<renf_elem_class>, renf_elem_class>::operator==(const Vector<renf_elem_class>&) const noexcept;
 template class detail::VectorExact<VectorAlongTriangulation<renf_elem_class>, renf_elem_class>;
 extern template Vector<renf_elem_class>& VectorBase<Vector<renf_elem_class>>::operator+=(const Vector<renf_elem_class>&);
@@ -298,7 +450,7 @@ extern template ORIENTATION VectorExact<Vector<Element<IntegerRing>>, Element<In
 template class VectorAlongTriangulation<Element<IntegerRing>>;
 extern template Element<IntegerRing> VectorExact<Vector<Element<IntegerRing>>, Element<IntegerRing>>::x() const noexcept;
 extern template Element<IntegerRing> VectorExact<Vector<Element<IntegerRing>>, Element<IntegerRing>>::y() const noexcept;
-extern template Element<IntegerRing> VectorExact<Vector<Element<IntegerRing>>, Element<IntegerRing>>::operator*(const Vector<Element<IntegerRing>>&)const noexcept;
+extern template Element<IntegerRing> VectorExact<Vector<Element<IntegerRing>>, Element<IntegerRing>>::operator*(const Vector<Element<IntegerRing>>&) const;
 extern template bool VectorExact<Vector<Element<IntegerRing>>, Element<IntegerRing>>::operator==(const Vector<Element<IntegerRing>>&) const noexcept;
 template class detail::VectorExact<VectorAlongTriangulation<Element<IntegerRing>>, Element<IntegerRing>>;
 extern template Vector<Element<IntegerRing>>& VectorBase<Vector<Element<IntegerRing>>>::operator+=(const Vector<Element<IntegerRing>>&);
@@ -326,7 +478,7 @@ extern template ORIENTATION VectorExact<Vector<Element<RationalField>>, Element<
 template class VectorAlongTriangulation<Element<RationalField>>;
 extern template Element<RationalField> VectorExact<Vector<Element<RationalField>>, Element<RationalField>>::x() const noexcept;
 extern template Element<RationalField> VectorExact<Vector<Element<RationalField>>, Element<RationalField>>::y() const noexcept;
-extern template Element<RationalField> VectorExact<Vector<Element<RationalField>>, Element<RationalField>>::operator*(const Vector<Element<RationalField>>&)const noexcept;
+extern template Element<RationalField> VectorExact<Vector<Element<RationalField>>, Element<RationalField>>::operator*(const Vector<Element<RationalField>>&) const;
 extern template bool VectorExact<Vector<Element<RationalField>>, Element<RationalField>>::operator==(const Vector<Element<RationalField>>&) const noexcept;
 template class detail::VectorExact<VectorAlongTriangulation<Element<RationalField>>, Element<RationalField>>;
 extern template Vector<Element<RationalField>>& VectorBase<Vector<Element<RationalField>>>::operator+=(const Vector<Element<RationalField>>&);
@@ -354,7 +506,7 @@ extern template ORIENTATION VectorExact<Vector<Element<NumberField>>, Element<Nu
 template class VectorAlongTriangulation<Element<NumberField>>;
 extern template Element<NumberField> VectorExact<Vector<Element<NumberField>>, Element<NumberField>>::x() const noexcept;
 extern template Element<NumberField> VectorExact<Vector<Element<NumberField>>, Element<NumberField>>::y() const noexcept;
-extern template Element<NumberField> VectorExact<Vector<Element<NumberField>>, Element<NumberField>>::operator*(const Vector<Element<NumberField>>&)const noexcept;
+extern template Element<NumberField> VectorExact<Vector<Element<NumberField>>, Element<NumberField>>::operator*(const Vector<Element<NumberField>>&) const;
 extern template bool VectorExact<Vector<Element<NumberField>>, Element<NumberField>>::operator==(const Vector<Element<NumberField>>&) const noexcept;
 template class detail::VectorExact<VectorAlongTriangulation<Element<NumberField>>, Element<NumberField>>;
 extern template Vector<Element<NumberField>>& VectorBase<Vector<Element<NumberField>>>::operator+=(const Vector<Element<NumberField>>&);
@@ -20,6 +20,7 @@
 
 #include <gtest/gtest.h>
 #include <boost/lexical_cast.hpp>
+#include <cereal/archives/binary.hpp>
 #include <cereal/archives/json.hpp>
 
 #include <flatsurf/cereal.hpp>
@@ -28,6 +29,8 @@
 #include "surfaces.hpp"
 
 using namespace flatsurf;
+using cereal::BinaryInputArchive;
+using cereal::BinaryOutputArchive;
 using cereal::JSONInputArchive;
 using cereal::JSONOutputArchive;
 using eantic::renf_class;
@@ -143,6 +146,66 @@ TEST(CerealTest, SaddleConnection) {
   test_serialization(**sc.begin());
 }
 
+TEST(CerealTest, SaddleConnectionsIterator) {
+  auto square = makeSquare<Vector<long long>>();
+  for (const auto& search : {SaddleConnections(square, Bound(8)), SaddleConnections(square, Bound(8), Vector<long long>(1, 0), Vector<long long>(1, 1)), SaddleConnections(square, Bound(8)).withSymmetries()}) {
+    // Checkpoint the search at every saddle connection and continue from there.
+    for (auto it = search.begin();; ++it) {
+      std::stringstream s;
+
+      {
+        BinaryOutputArchive archive(s);
+        archive(cereal::make_nvp("test", it));
+      }
+
+      auto restored = search.begin();
+
+      {
+        BinaryInputArchive archive(s);
+        archive(cereal::make_nvp("test", restored));
+      }
+
+      ASSERT_EQ(restored, it);
+
+      if (it == search.end()) break;
+
+      for (auto rest = it; rest != search.end(); ++rest, ++restored) {
+        ASSERT_NE(restored, search.end());
+        EXPECT_EQ(**restored, **rest);
+      }
+      EXPECT_EQ(restored, search.end());
+    }
+  }
+}
+
+TEST(CerealTest, SaddleConnectionsSink) {
+  using Sink = SaddleConnections<FlatTriangulation<long long>>::Sink;
+
+  auto square = makeSquare<Vector<long long>>();
+  Sink sink;
+  SaddleConnections(square, Bound(8)).shard(0, 2).collect(sink);
+
+  std::stringstream s;
+
+  {
+    JSONOutputArchive archive(s);
+    archive(cereal::make_nvp("test", sink));
+  }
+
+  Sink restored;
+
+  {
+    JSONInputArchive archive(s);
+    archive(cereal::make_nvp("test", restored));
+  }
+
+  EXPECT_EQ(*restored.surface, *sink.surface);
+  EXPECT_EQ(restored.source, sink.source);
+  EXPECT_EQ(restored.target, sink.target);
+  EXPECT_EQ(restored.x, sink.x);
+  EXPECT_EQ(restored.y, sink.y);
+}
+
 }  // namespace flatsurf
 
 #include "main.hpp"
@@ -20,9 +20,12 @@
 
 #include <gtest/gtest.h>
 #include <boost/lexical_cast.hpp>
+#include <exact-real/arb.hpp>
 
 #include <flatsurf/delaunay_triangulation.hpp>
+#include <flatsurf/flat_triangulation.hpp>
 #include <flatsurf/half_edge.hpp>
+#include <flatsurf/vector.hpp>
 #include <intervalxt/length.hpp>
 
 #include "surfaces.hpp"
@@ -48,6 +51,29 @@ TEST(DelaunayTest, Square) {
     }
   }
 }
+
+TEST(DelaunayTest, Approximations) {
+  using T = eantic::renf_elem_class;
+  using Vector = Vector<T>;
+  auto hexagon = makeHexagon<Vector>();
+
+  // The approximations are updated when flipping (after they have been
+  // computed for the first time.) They do not get any worse than
+  // approximating the exact vectors directly.
+  hexagon->fromEdgeApproximate(HalfEdge(1));
+
+  for (int i = 0; i < 8; i++) {
+    for (auto halfEdge : hexagon->halfEdges()) {
+      hexagon->flip(halfEdge);
+      for (auto edge : hexagon->halfEdges()) {
+        const auto approximation = hexagon->fromEdgeApproximate(edge);
+        const auto exact = static_cast<flatsurf::Vector<exactreal::Arb>>(hexagon->fromEdge(edge));
+        EXPECT_TRUE(approximation.x().equal(exact.x()));
+        EXPECT_TRUE(approximation.y().equal(exact.y()));
+      }
+    }
+  }
+}
 }  // namespace
 
 #include "main.hpp"
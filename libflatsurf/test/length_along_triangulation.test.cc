@@ -50,6 +50,10 @@ TEST(LengthAlongTriangulationTest, Square) {
   EXPECT_EQ(v10 / v01, 7 / 3);
   EXPECT_EQ(2 * v10 / v01, 2 * 7 / 3);
   EXPECT_EQ(3 * v10 / v01, 7);
+
+  EXPECT_THROW(v10 *= mpz_class(1) << 64, std::invalid_argument);
+  v10 *= mpz_class(1) << 62;
+  EXPECT_THROW(v10 *= mpz_class(4), std::invalid_argument);
 }
 }  // namespace
 
@@ -27,10 +27,16 @@
 #include <flatsurf/half_edge.hpp>
 #include <flatsurf/saddle_connection.hpp>
 #include <flatsurf/saddle_connections.hpp>
+#include <flatsurf/saddle_connections_by_direction.hpp>
+#include <flatsurf/saddle_connections_by_length.hpp>
+#include <flatsurf/saddle_connections_in_direction.hpp>
+#include <flatsurf/shortest_saddle_connections.hpp>
 #include <flatsurf/vector.hpp>
 #include <flatsurf/vector_along_triangulation.hpp>
 #include <intervalxt/length.hpp>
 
+#include <flatsurf/config.h>
+
 #include "surfaces.hpp"
 
 using std::vector;
@@ -40,6 +46,30 @@ using namespace flatsurf;
 using eantic::renf_class;
 
 namespace {
+// Run the search to the end and report the work it did in the counters of
+// the benchmark (when configured with --enable-statistics.)
+template <typename Surface>
+size_t run(benchmark::State& state, const SaddleConnections<Surface>& connections) {
+  size_t count = 0;
+  auto it = connections.begin();
+  const auto end = connections.end();
+  for (; it != end; ++it)
+    count++;
+
+  if (const auto statistics = it.statistics()) {
+    state.counters["triangles"] = statistics->triangles;
+    state.counters["applyMoves"] = statistics->applyMoves;
+    state.counters["moves"] = statistics->moves;
+    state.counters["collapsed"] = statistics->collapsed;
+    state.counters["depth"] = statistics->depth;
+    state.counters["approximate"] = statistics->approximate;
+    state.counters["exact"] = statistics->exact;
+    state.counters["pruned"] = statistics->pruned;
+  }
+
+  return count;
+}
+
 template <class R2>
 void SaddleConnectionsSquare(benchmark::State& state) {
   auto square = makeSquare<R2>();
@@ -63,6 +93,143 @@ void SaddleConnectionsSquare(benchmark::State& state) {
 BENCHMARK_TEMPLATE(SaddleConnectionsSquare, Vector<long long>)->Args({64, 980});
 BENCHMARK_TEMPLATE(SaddleConnectionsSquare, Vector<eantic::renf_elem_class>)->Args({64, 980});
 
+template <class R2>
+void SaddleConnectionsSearch(benchmark::State& state) {
+  auto surface = makeHeptagonL<R2>();
+  auto bound = Bound(state.range(0));
+  for (auto _ : state) {
+    auto connections = SaddleConnections(surface, bound);
+    benchmark::DoNotOptimize(run(state, connections));
+  }
+#ifdef LIBFLATSURF_COROUTINES
+  state.SetLabel("coroutine");
+#else
+  state.SetLabel("state machine");
+#endif
+}
+BENCHMARK_TEMPLATE(SaddleConnectionsSearch, Vector<eantic::renf_elem_class>)->Arg(16)->Arg(32);
+
+template <class R2>
+void SaddleConnectionsCount(benchmark::State& state) {
+  auto surface = makeHeptagonL<R2>();
+  auto bound = Bound(state.range(0));
+  for (auto _ : state) {
+    auto connections = SaddleConnections(surface, bound);
+    benchmark::DoNotOptimize(connections.count());
+  }
+}
+BENCHMARK_TEMPLATE(SaddleConnectionsCount, Vector<eantic::renf_elem_class>)->Arg(16)->Arg(32);
+
+template <class R2>
+void SaddleConnectionsWithSymmetries(benchmark::State& state) {
+  auto surface = makeHeptagonL<R2>();
+  auto bound = Bound(state.range(0));
+  for (auto _ : state) {
+    auto connections = SaddleConnections(surface, bound).withSymmetries();
+    benchmark::DoNotOptimize(std::distance(connections.begin(), connections.end()));
+  }
+}
+BENCHMARK_TEMPLATE(SaddleConnectionsWithSymmetries, Vector<eantic::renf_elem_class>)->Arg(16)->Arg(32);
+
+template <class R2>
+void SaddleConnectionsCountWithSymmetries(benchmark::State& state) {
+  auto surface = makeHeptagonL<R2>();
+  auto bound = Bound(state.range(0));
+  for (auto _ : state) {
+    auto connections = SaddleConnections(surface, bound).withSymmetries();
+    benchmark::DoNotOptimize(connections.count());
+  }
+}
+BENCHMARK_TEMPLATE(SaddleConnectionsCountWithSymmetries, Vector<eantic::renf_elem_class>)->Arg(16)->Arg(32);
+
+template <class R2>
+void SaddleConnectionsGrow(benchmark::State& state) {
+  auto surface = makeHeptagonL<R2>();
+  for (auto _ : state) {
+    auto connections = SaddleConnections(surface, Bound(2));
+    benchmark::DoNotOptimize(std::distance(connections.begin(), connections.end()));
+    for (int radius = 4; radius <= state.range(0); radius *= 2) {
+      connections = connections.grow(Bound(radius));
+      benchmark::DoNotOptimize(std::distance(connections.begin(), connections.end()));
+    }
+  }
+}
+BENCHMARK_TEMPLATE(SaddleConnectionsGrow, Vector<eantic::renf_elem_class>)->Arg(16)->Arg(32);
+
+template <class R2>
+void SaddleConnectionsWindow(benchmark::State& state) {
+  auto surface = makeHeptagonL<R2>();
+  auto bound = Bound(state.range(0));
+  for (auto _ : state) {
+    auto connections = SaddleConnections(surface, bound, R2(64, -1), R2(64, 1));
+    benchmark::DoNotOptimize(run(state, connections));
+  }
+}
+BENCHMARK_TEMPLATE(SaddleConnectionsWindow, Vector<eantic::renf_elem_class>)->Arg(16)->Arg(32);
+
+template <class R2>
+void SaddleConnectionsSearchByLength(benchmark::State& state) {
+  auto surface = makeHeptagonL<R2>();
+  auto bound = Bound(state.range(0));
+  for (auto _ : state) {
+    auto connections = SaddleConnectionsByLength(surface, bound);
+    benchmark::DoNotOptimize(std::distance(connections.begin(), connections.end()));
+  }
+}
+BENCHMARK_TEMPLATE(SaddleConnectionsSearchByLength, Vector<eantic::renf_elem_class>)->Arg(16);
+
+template <class R2>
+void SaddleConnectionsSearchByDirection(benchmark::State& state) {
+  auto surface = makeHeptagonL<R2>();
+  auto bound = Bound(state.range(0));
+  for (auto _ : state) {
+    auto connections = SaddleConnectionsByDirection(surface, bound);
+    benchmark::DoNotOptimize(std::distance(connections.begin(), connections.end()));
+  }
+}
+BENCHMARK_TEMPLATE(SaddleConnectionsSearchByDirection, Vector<eantic::renf_elem_class>)->Arg(16);
+
+template <class R2>
+void SaddleConnectionsSearchInDirection(benchmark::State& state) {
+  auto surface = makeHeptagonL<R2>();
+  auto bound = Bound(state.range(0));
+
+  vector<R2> directions;
+  for (const auto& connection : SaddleConnections(surface, Bound(4)))
+    directions.push_back(connection->vector());
+
+  for (auto _ : state) {
+    auto connections = SaddleConnectionsInDirection(surface, directions[0], bound);
+    for (const auto& direction : directions) {
+      connections = connections.inDirection(direction);
+      benchmark::DoNotOptimize(connections.size());
+    }
+  }
+}
+BENCHMARK_TEMPLATE(SaddleConnectionsSearchInDirection, Vector<eantic::renf_elem_class>)->Arg(16)->Arg(256);
+
+template <class R2>
+void SaddleConnectionsShortest(benchmark::State& state) {
+  auto surface = makeHeptagonL<R2>();
+  for (auto _ : state) {
+    auto connections = ShortestSaddleConnections(surface, state.range(0));
+    benchmark::DoNotOptimize(connections.size());
+  }
+}
+BENCHMARK_TEMPLATE(SaddleConnectionsShortest, Vector<eantic::renf_elem_class>)->Arg(16)->Arg(1024);
+
+template <class R2>
+void SaddleConnectionsParallel(benchmark::State& state) {
+  auto surface = makeHeptagonL<R2>();
+  auto bound = Bound(state.range(0));
+  auto threads = state.range(1);
+  for (auto _ : state) {
+    auto connections = SaddleConnections(surface, bound);
+    benchmark::DoNotOptimize(connections.parallel(threads));
+  }
+}
+BENCHMARK_TEMPLATE(SaddleConnectionsParallel, Vector<eantic::renf_elem_class>)->Args({16, 1})->Args({16, 2})->Args({16, 4})->Args({16, 8})->UseRealTime();
+
 }  // namespace
 
 #include "main.hpp"
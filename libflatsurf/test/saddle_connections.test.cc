@@ -20,6 +20,9 @@
 
 #include <gtest/gtest.h>
 #include <boost/lexical_cast.hpp>
+#include <iterator>
+#include <numeric>
+#include <thread>
 
 #include <exact-real/element.hpp>
 #include <exact-real/number_field.hpp>
@@ -27,8 +30,14 @@
 
 #include <flatsurf/flat_triangulation.hpp>
 #include <flatsurf/half_edge.hpp>
+#include <flatsurf/permutation.hpp>
+#include <flatsurf/precision.hpp>
 #include <flatsurf/saddle_connection.hpp>
 #include <flatsurf/saddle_connections.hpp>
+#include <flatsurf/saddle_connections_by_direction.hpp>
+#include <flatsurf/saddle_connections_by_length.hpp>
+#include <flatsurf/saddle_connections_in_direction.hpp>
+#include <flatsurf/shortest_saddle_connections.hpp>
 #include <flatsurf/vector.hpp>
 #include <flatsurf/vector_along_triangulation.hpp>
 
@@ -48,12 +57,81 @@ class SaddleConnectionsTest : public Test {};
 using ExactVectors = Types<Vector<long long>, Vector<renf_elem_class>, Vector<exactreal::Element<exactreal::NumberField>>>;
 TYPED_TEST_CASE(SaddleConnectionsTest, ExactVectors);
 
+// Return the regular hexagon or, if it cannot be described with the
+// coordinates of R2, the unit square.
+template <typename R2>
+auto makeSurface() {
+  if constexpr (std::is_same_v<R2, Vector<long long>>)
+    return makeSquare<R2>();
+  else
+    return makeHexagon<R2>();
+}
+
+// Return the surfaces from makeSurface() and, if R2 is over a number field,
+// a surface whose field has degree three. The embedding of such a field is
+// refined lazily, so it exercises the locking in the parallel search.
+template <typename R2>
+auto makeSurfaces() {
+  vector<decltype(makeSurface<R2>())> ret{makeSurface<R2>()};
+  if constexpr (std::is_same_v<R2, Vector<renf_elem_class>>)
+    ret.push_back(makeHeptagonL<R2>());
+  return ret;
+}
+
+// Return a representation of a saddle connection that can be compared across
+// different searches.
+template <typename Connection>
+std::string print(const Connection& connection) {
+  return boost::lexical_cast<std::string>(connection);
+}
+
+// Return the saddle connections that connections point to, printed and
+// sorted.
+template <typename Connections>
+vector<std::string> sorted(const Connections& connections) {
+  vector<std::string> ret;
+  for (const auto& connection : connections)
+    ret.push_back(print(*connection));
+  std::sort(ret.begin(), ret.end());
+  return ret;
+}
+
+// Return the saddle connections on surface up to length bound as found by a
+// plain search, printed and sorted.
+template <typename Surface>
+vector<std::string> expected(const std::shared_ptr<Surface>& surface, const Bound bound) {
+  return sorted(SaddleConnections(surface, bound));
+}
+
 TYPED_TEST(SaddleConnectionsTest, Trivial) {
   auto square = makeSquare<TypeParam>();
   auto connections = SaddleConnections(square, 0, HalfEdge(1));
   EXPECT_EQ(connections.begin(), connections.end());
 }
 
+TYPED_TEST(SaddleConnectionsTest, End) {
+  auto square = makeSquare<TypeParam>();
+  auto connections = SaddleConnections(square, 16, HalfEdge(1));
+
+  auto it = connections.begin();
+  for (int i = 0; i < 60; i++) {
+    EXPECT_NE(it, connections.end());
+    EXPECT_NE(connections.end(), it);
+    ++it;
+  }
+  EXPECT_EQ(it, connections.end());
+  EXPECT_EQ(connections.end(), it);
+  EXPECT_EQ(connections.end(), SaddleConnections(square, 8).end());
+  EXPECT_THROW(*connections.end(), std::out_of_range);
+  auto end = connections.end();
+  EXPECT_THROW(++end, std::out_of_range);
+
+#if __cpp_lib_ranges
+  static_assert(std::ranges::input_range<decltype(connections)>);
+  EXPECT_EQ(std::ranges::distance(connections), 60);
+#endif
+}
+
 TYPED_TEST(SaddleConnectionsTest, Square) {
   auto square = makeSquare<TypeParam>();
   auto bound = 16;
@@ -103,6 +181,374 @@ TYPED_TEST(SaddleConnectionsTest, Hexagon) {
     EXPECT_EQ(std::distance(connections.begin(), connections.end()), 216);
   }
 }
+
+TYPED_TEST(SaddleConnectionsTest, MaximumPrecision) {
+  if constexpr (std::is_same_v<TypeParam, Vector<long long>>) {
+    // An regular hexagon can not be constructed with integer coordinates.
+    return;
+  } else {
+    auto hexagon = makeHexagon<TypeParam>();
+    auto connections = SaddleConnections(hexagon, Bound(16));
+
+    const long precision = maximumPrecision();
+
+    // The predicates of the search give the same answers no matter how
+    // much precision they use before falling back to exact arithmetic.
+    for (long bits : {0l, 64l, 1024l}) {
+      maximumPrecision(bits);
+      EXPECT_EQ(std::distance(connections.begin(), connections.end()), 216);
+    }
+
+    maximumPrecision(precision);
+    EXPECT_EQ(maximumPrecision(), precision);
+
+    if (auto statistics = precisionStatistics())
+      EXPECT_GT(std::accumulate(statistics->begin(), statistics->end(), size_t()), 0);
+  }
+}
+
+TYPED_TEST(SaddleConnectionsTest, Collect) {
+  auto square = makeSquare<TypeParam>();
+  auto connections = SaddleConnections(square, Bound(16));
+
+  typename decltype(connections)::Sink sink;
+  connections.collect(sink);
+  ASSERT_EQ(sink.size(), 480);
+  EXPECT_EQ(sink.surface, square);
+
+  size_t i = 0;
+  for (const auto& connection : connections) {
+    EXPECT_EQ(sink.source[i], connection->source());
+    EXPECT_EQ(sink.target[i], connection->target());
+    EXPECT_EQ(TypeParam(sink.x[i], sink.y[i]), connection->vector());
+    i++;
+  }
+
+  connections.collect(sink);
+  EXPECT_EQ(sink.size(), 960);
+}
+
+TYPED_TEST(SaddleConnectionsTest, Count) {
+  auto surface = makeSurface<TypeParam>();
+
+  auto connections = SaddleConnections(surface, Bound(16));
+  EXPECT_EQ(connections.count(), std::distance(connections.begin(), connections.end()));
+
+  const vector<Bound> bins{Bound(1), Bound(2), Bound(4), Bound(8)};
+  vector<size_t> expected(bins.size());
+  for (const auto& connection : connections)
+    for (size_t i = 0; i < bins.size(); i++)
+      if (!(connection->vector() > bins[i])) {
+        expected[i]++;
+        break;
+      }
+  EXPECT_EQ(connections.count(bins), expected);
+
+  EXPECT_THROW(connections.count({Bound(2), Bound(1)}), std::invalid_argument);
+}
+
+TYPED_TEST(SaddleConnectionsTest, Parallel) {
+  for (auto surface : makeSurfaces<TypeParam>()) {
+    auto connections = SaddleConnections(surface, Bound(16));
+    const auto all = expected(surface, Bound(16));
+
+    for (size_t threads : {1, 2, 5})
+      EXPECT_EQ(sorted(connections.parallel(threads)), all);
+  }
+}
+
+TYPED_TEST(SaddleConnectionsTest, ConcurrentVector) {
+  using Surface = FlatTriangulation<typename TypeParam::Coordinate>;
+
+  for (auto surface : makeSurfaces<TypeParam>()) {
+    // The vectors of the saddle connections are computed lazily when several
+    // threads ask for them at once.
+    vector<std::unique_ptr<SaddleConnection<Surface>>> connections;
+    for (const auto& connection : SaddleConnections(surface, Bound(16)))
+      connections.push_back(std::make_unique<SaddleConnection<Surface>>(*connection));
+
+    vector<std::thread> threads;
+    for (int i = 0; i < 4; i++)
+      threads.emplace_back([&]() {
+        for (const auto& connection : connections)
+          connection->vector();
+      });
+    for (auto& thread : threads)
+      thread.join();
+
+    auto expected = SaddleConnections(surface, Bound(16)).begin();
+    for (const auto& connection : connections) {
+      EXPECT_EQ(connection->vector(), (*expected)->vector());
+      ++expected;
+    }
+  }
+}
+
+TYPED_TEST(SaddleConnectionsTest, VectorBeforeFlip) {
+  auto surface = makeSurface<TypeParam>();
+
+  // Once the vectors of the saddle connections have been computed, they do
+  // not change when the surface is modified.
+  auto connections = SaddleConnections(surface, Bound(8)).parallel();
+  vector<TypeParam> vectors;
+  for (const auto& connection : connections)
+    vectors.push_back(connection->vector());
+
+  surface->flip(HalfEdge(1));
+
+  for (size_t i = 0; i < connections.size(); i++)
+    EXPECT_EQ(connections[i]->vector(), vectors[i]);
+}
+
+TYPED_TEST(SaddleConnectionsTest, Grow) {
+  auto surface = makeSurface<TypeParam>();
+
+  // The saddle connections of length in (inner, outer].
+  const auto annulus = [&](int inner, int outer) {
+    auto all = expected(surface, Bound(outer));
+    auto shorter = expected(surface, Bound(inner));
+    vector<std::string> ret;
+    std::set_difference(all.begin(), all.end(), shorter.begin(), shorter.end(), std::back_inserter(ret));
+    return ret;
+  };
+
+  auto connections = SaddleConnections(surface, Bound(4));
+
+  // Grow a search that has never run to the end.
+  EXPECT_EQ(sorted(connections.grow(Bound(8))), annulus(4, 8));
+
+  // Grow a search that knows where it stopped.
+  sorted(connections);
+  auto grown = connections.grow(Bound(8));
+  EXPECT_EQ(sorted(grown), annulus(4, 8));
+  EXPECT_EQ(sorted(grown.grow(Bound(16))), annulus(8, 16));
+  EXPECT_EQ(sorted(grown.grow(Bound(8))), vector<std::string>{});
+
+  EXPECT_EQ(sorted(grown.grow(Bound(16)).parallel(2)), annulus(8, 16));
+}
+
+TYPED_TEST(SaddleConnectionsTest, Window) {
+  auto surface = makeSurface<TypeParam>();
+
+  const auto all = SaddleConnections(surface, Bound(16));
+
+  for (const auto& window : vector<std::pair<TypeParam, TypeParam>>{{{1, 0}, {0, 1}}, {{3, 1}, {1, 2}}, {{-1, -3}, {2, -1}}, {{7, -1}, {7, 1}}}) {
+    const auto& [begin, end] = window;
+
+    vector<std::string> expected;
+    for (const auto& connection : all)
+      if (begin.ccw(connection->vector()) == CCW::COUNTERCLOCKWISE && connection->vector().ccw(end) == CCW::COUNTERCLOCKWISE)
+        expected.push_back(print(*connection));
+    std::sort(expected.begin(), expected.end());
+
+    EXPECT_EQ(sorted(SaddleConnections(surface, Bound(16), begin, end)), expected);
+  }
+
+  EXPECT_THROW(SaddleConnections(surface, Bound(16), TypeParam(1, 0), TypeParam(-1, 0)), std::invalid_argument);
+}
+
+TYPED_TEST(SaddleConnectionsTest, Crossings) {
+  auto surface = makeSurface<TypeParam>();
+
+  // Compare recorded crossings to the ones that the saddle connections
+  // reconstruct by themselves.
+  const auto compare = [](const auto& plain, const auto& recording) {
+    auto it = plain.begin();
+    for (const auto& connection : recording) {
+      ASSERT_NE(it, plain.end());
+      EXPECT_EQ(**it, *connection);
+      EXPECT_EQ((*it)->crossings(), connection->crossings());
+      ++it;
+    }
+    EXPECT_EQ(it, plain.end());
+  };
+
+  const auto plain = SaddleConnections(surface, Bound(8));
+  const auto recording = plain.withCrossings();
+  compare(plain, recording);
+  compare(plain.grow(Bound(12)), recording.grow(Bound(12)));
+
+  for (const auto& connection : recording.parallel(2)) {
+    auto reconstructed = SaddleConnections(surface, Bound(8), connection->source());
+    for (const auto& candidate : reconstructed)
+      if (*candidate == *connection)
+        EXPECT_EQ(candidate->crossings(), connection->crossings());
+  }
+}
+
+TYPED_TEST(SaddleConnectionsTest, Symmetries) {
+  auto surface = makeSurface<TypeParam>();
+
+  const auto automorphisms = surface->automorphisms();
+  // Both surfaces can be turned by π.
+  EXPECT_GE(automorphisms.size(), 2);
+  for (auto e : surface->halfEdges())
+    EXPECT_EQ(automorphisms[0](e), e);
+
+  const auto symmetric = SaddleConnections(surface, Bound(16)).withSymmetries();
+  const auto all = expected(surface, Bound(16));
+
+  EXPECT_EQ(sorted(symmetric), all);
+  EXPECT_EQ(symmetric.count(), all.size());
+
+  typename SaddleConnections<FlatTriangulation<typename TypeParam::Coordinate>>::Sink sink;
+  symmetric.collect(sink);
+  EXPECT_EQ(sink.size(), all.size());
+
+  EXPECT_EQ(sorted(symmetric.parallel(2)), all);
+}
+
+TYPED_TEST(SaddleConnectionsTest, ByLength) {
+  using T = typename TypeParam::Coordinate;
+
+  auto surface = makeSurface<TypeParam>();
+  const auto connections = SaddleConnectionsByLength(surface, Bound(16));
+
+  std::optional<T> previous;
+  for (const auto& connection : connections) {
+    const T norm = connection->vector() * connection->vector();
+    if (previous)
+      EXPECT_FALSE(norm < *previous);
+    previous = norm;
+  }
+
+  const auto all = expected(surface, Bound(16));
+  EXPECT_EQ(sorted(connections), all);
+
+  // Without a search radius, the saddle connections keep coming.
+  auto connection = SaddleConnectionsByLength(surface).begin();
+  std::advance(connection, all.size());
+  EXPECT_TRUE((*connection)->vector() > Bound(16));
+}
+
+TYPED_TEST(SaddleConnectionsTest, ByDirection) {
+  auto surface = makeSurface<TypeParam>();
+  const auto connections = SaddleConnectionsByDirection(surface, Bound(16));
+
+  // Whether the vector is in the upper half plane (including the direction
+  // of (1, 0).)
+  const auto upper = [](const TypeParam& v) {
+    const TypeParam horizontal(1, 0);
+    const auto ccw = horizontal.ccw(v);
+    return ccw == CCW::COUNTERCLOCKWISE || (ccw == CCW::COLLINEAR && horizontal.orientation(v) == ORIENTATION::SAME);
+  };
+
+  std::optional<TypeParam> previous;
+  for (const auto& connection : connections) {
+    const TypeParam v = connection->vector();
+    if (previous) {
+      if (upper(*previous) == upper(v))
+        EXPECT_NE(previous->ccw(v), CCW::CLOCKWISE);
+      else
+        EXPECT_TRUE(upper(*previous));
+    }
+    previous = v;
+  }
+
+  EXPECT_EQ(sorted(connections), expected(surface, Bound(16)));
+}
+
+TYPED_TEST(SaddleConnectionsTest, InDirection) {
+  auto surface = makeSurface<TypeParam>();
+
+  vector<TypeParam> vectors;
+  vector<std::string> connections;
+  for (const auto& connection : SaddleConnections(surface, Bound(16))) {
+    vectors.push_back(connection->vector());
+    connections.push_back(print(*connection));
+  }
+
+  auto inDirection = SaddleConnectionsInDirection(surface, vectors[0], Bound(16));
+  for (size_t i = 0; i < std::min<size_t>(vectors.size(), 32); i++) {
+    const TypeParam& direction = vectors[i];
+    inDirection = inDirection.inDirection(direction);
+
+    vector<std::string> parallel;
+    for (size_t j = 0; j < vectors.size(); j++)
+      if (direction.ccw(vectors[j]) == CCW::COLLINEAR && direction.orientation(vectors[j]) == ORIENTATION::SAME)
+        parallel.push_back(connections[j]);
+    std::sort(parallel.begin(), parallel.end());
+
+    vector<std::string> found;
+    for (const auto& connection : inDirection)
+      found.push_back(print(connection));
+    std::sort(found.begin(), found.end());
+
+    EXPECT_EQ(found, parallel);
+  }
+}
+
+TYPED_TEST(SaddleConnectionsTest, Shortest) {
+  using T = typename TypeParam::Coordinate;
+
+  auto surface = makeSurface<TypeParam>();
+
+  vector<T> lengths;
+  for (const auto& connection : SaddleConnections(surface, Bound(16)))
+    lengths.push_back(connection->vector() * connection->vector());
+  std::sort(lengths.begin(), lengths.end());
+
+  const auto all = expected(surface, Bound(16));
+
+  for (size_t k : {0, 1, 10, 64}) {
+    auto shortest = ShortestSaddleConnections(surface, k);
+    ASSERT_EQ(shortest.size(), k);
+
+    vector<T> found;
+    for (const auto& connection : shortest) {
+      found.push_back(connection.vector() * connection.vector());
+      EXPECT_TRUE(std::binary_search(all.begin(), all.end(), print(connection)));
+    }
+    EXPECT_EQ(found, vector<T>(lengths.begin(), lengths.begin() + k));
+  }
+}
+
+TYPED_TEST(SaddleConnectionsTest, Shard) {
+  using Surface = FlatTriangulation<typename TypeParam::Coordinate>;
+
+  auto surface = makeSurface<TypeParam>();
+
+  const auto collect = [](const auto& connections) {
+    typename SaddleConnections<Surface>::Sink sink;
+    connections.collect(sink);
+    return sink;
+  };
+
+  // We create every search twice to check that the shards of searches that
+  // have been created independently agree.
+  const auto searches = [&]() {
+    return vector{SaddleConnections(surface, Bound(16)), SaddleConnections(surface, Bound(16), TypeParam(3, 1), TypeParam(1, 2)), SaddleConnections(surface, Bound(16)).withSymmetries(), SaddleConnections(surface, Bound(4)).grow(Bound(16))};
+  };
+  const auto searched = searches();
+  const auto independent = searches();
+
+  for (size_t i = 0; i < searched.size(); i++) {
+    const auto& search = searched[i];
+
+    vector<typename SaddleConnections<Surface>::Sink> all;
+    all.push_back(collect(search));
+    const auto expected = SaddleConnections<Surface>::merge(std::move(all));
+
+    for (size_t shards : {1, 2, 3, 7}) {
+      size_t count = 0;
+      vector<typename SaddleConnections<Surface>::Sink> sinks;
+      for (size_t shard = 0; shard < shards; shard++) {
+        count += search.shard(shard, shards).count();
+        sinks.push_back(collect(independent[i].shard(shard, shards)));
+      }
+      EXPECT_EQ(count, expected.size());
+
+      const auto merged = SaddleConnections<Surface>::merge(std::move(sinks));
+      ASSERT_EQ(merged.size(), expected.size());
+      EXPECT_EQ(merged.source, expected.source);
+      EXPECT_EQ(merged.target, expected.target);
+      EXPECT_EQ(merged.x, expected.x);
+      EXPECT_EQ(merged.y, expected.y);
+    }
+  }
+
+  EXPECT_THROW(SaddleConnections(surface, Bound(16)).shard(2, 2), std::invalid_argument);
+}
 }  // namespace
 
 #include "main.hpp"
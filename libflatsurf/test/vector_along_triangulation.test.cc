@@ -0,0 +1,77 @@
+/**********************************************************************
+ *  This file is part of flatsurf.
+ *
+ *        Copyright (C) 2020 Julian Rüth
+ *
+ *  Flatsurf is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, either version 3 of the License, or
+ *  (at your option) any later version.
+ *
+ *  Flatsurf is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with flatsurf. If not, see <https://www.gnu.org/licenses/>.
+ *********************************************************************/
+
+#include <gtest/gtest.h>
+#include <exact-real/arb.hpp>
+
+#include <flatsurf/delaunay_triangulation.hpp>
+#include <flatsurf/flat_triangulation.hpp>
+#include <flatsurf/half_edge.hpp>
+#include <flatsurf/vector.hpp>
+#include <flatsurf/vector_along_triangulation.hpp>
+
+#include "surfaces.hpp"
+
+using namespace flatsurf;
+using std::vector;
+
+namespace {
+TEST(VectorAlongTriangulationTest, ExactAcrossFlips) {
+  using T = Element<exactreal::IntegerRing>;
+  using Vector = Vector<T>;
+  using Along = VectorAlongTriangulation<T, exactreal::Arb>;
+  auto square = makeSquare<Vector>();
+
+  Along v(square, vector<HalfEdge>{HalfEdge(1)});
+  Vector expected = square->fromEdge(HalfEdge(1));
+
+  // Return the vector rebuilt from scratch from the coefficients of v.
+  const auto rebuilt = [&]() {
+    Along ret(square);
+    for (const auto& [e, c] : v.coefficients())
+      for (int i = 0; i < c; i++)
+        ret += e;
+    return static_cast<Vector>(ret);
+  };
+
+  // Compute the exact vector so that later additions are only pending.
+  EXPECT_EQ(static_cast<Vector>(v), expected);
+
+  for (auto halfEdge : square->halfEdges()) {
+    for (auto e : {HalfEdge(1), HalfEdge(2), HalfEdge(-3)}) {
+      v += e;
+      expected += square->fromEdge(e);
+    }
+
+    // Copies keep track of flips independently of v.
+    const Along copy = v;
+
+    // The half edges that have been added since we last read v must be
+    // rewritten when the edges they refer to are flipped.
+    square->flip(halfEdge);
+    DelaunayTriangulation<T>::transform(*square);
+
+    EXPECT_EQ(static_cast<Vector>(v), expected);
+    EXPECT_EQ(static_cast<Vector>(copy), expected);
+    EXPECT_EQ(rebuilt(), expected);
+  }
+}
+}  // namespace
+
+#include "main.hpp"
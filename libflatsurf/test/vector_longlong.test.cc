@@ -20,6 +20,8 @@
 
 #include <gtest/gtest.h>
 #include <boost/lexical_cast.hpp>
+#include <climits>
+#include <intervalxt/length.hpp>
 
 #include <flatsurf/vector.hpp>
 
@@ -38,4 +40,44 @@ TEST(VectorLongLongTest, CCW) {
   EXPECT_EQ(boost::lexical_cast<std::string>(vertical), "(2, 3)");
 }
 
+TEST(VectorLongLongTest, Scale) {
+  using V = Vector<long long>;
+
+  V v(2, -3);
+  v *= mpz_class(1) << 40;
+  EXPECT_EQ(v, V(2ll << 40, -3ll << 40));
+}
+
+TEST(VectorLongLongTest, Overflow) {
+  using V = Vector<long long>;
+  const long long max = LLONG_MAX;
+
+  // The products of these coordinates do not fit into a long long.
+  EXPECT_EQ(V(max, max - 1).ccw(V(max - 1, max - 2)), CCW::CLOCKWISE);
+  EXPECT_EQ(V(max - 1, max - 2).ccw(V(max, max - 1)), CCW::COUNTERCLOCKWISE);
+  EXPECT_EQ(V(max, max).ccw(V(-max, -max)), CCW::COLLINEAR);
+
+  EXPECT_EQ(V(max, -max).orientation(V(max - 1, max)), ORIENTATION::OPPOSITE);
+  EXPECT_EQ(V(max, max).orientation(V(max, -max)), ORIENTATION::ORTHOGONAL);
+  // Not even the sum of the products fits into 128 bits.
+  EXPECT_EQ(V(LLONG_MIN, LLONG_MIN).orientation(V(LLONG_MIN, LLONG_MIN)), ORIENTATION::SAME);
+
+  EXPECT_TRUE(V(max, max) > Bound(max));
+  EXPECT_FALSE(V(max, 0) < Bound(max));
+  EXPECT_TRUE(V(max - 1, 0) < Bound(max));
+  EXPECT_TRUE(V(3037000500, 0) > Bound(3037000499));
+  EXPECT_TRUE(V(LLONG_MIN, LLONG_MIN) > Bound(max));
+
+  // The scalar product is exact when the result fits into a long long…
+  EXPECT_EQ(V(max, max) * V(1, -1), 0);
+  EXPECT_EQ(V(max, 3037000499) * V(-1, 3037000499), 3037000499ll * 3037000499ll - max);
+  // …and throws otherwise.
+  EXPECT_THROW(V(max, max) * V(max, max), std::invalid_argument);
+  EXPECT_THROW(V(max, 0) * V(2, 0), std::invalid_argument);
+
+  V v(max, 0);
+  EXPECT_THROW(v *= mpz_class(1) << 64, std::invalid_argument);
+  EXPECT_THROW(v *= mpz_class(2), std::invalid_argument);
+}
+
 #include "main.hpp"
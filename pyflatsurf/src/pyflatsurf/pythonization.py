@@ -25,7 +25,8 @@ def enable_iterable(proxy, name):
         if not hasattr(proxy, '__iter__'):
             def iter(self):
                 i = self.begin()
-                while i != self.end():
+                end = self.end()
+                while i != end:
                     if hasattr(i, '__deref__'):
                         yield i.__deref__()
                     elif hasattr(i, 'dereference'):
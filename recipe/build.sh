@@ -10,6 +10,14 @@ fi
 $SNIPPETS_DIR/autoconf/run.sh
 $SNIPPETS_DIR/make/run.sh
 
+if [[ "$target" == "coroutines" ]]; then
+  # Run the test suite, which includes the saddle connection benchmarks, with
+  # the coroutine engine and show the timings in the build log so they can be
+  # compared to the ones of the state machine in the test target.
+  make check
+  cat test/saddle_connections_benchmark.log
+fi
+
 $SNIPPETS_DIR/clang-format/run.sh
 $SNIPPETS_DIR/asv/run.sh
 $SNIPPETS_DIR/todo/run.sh
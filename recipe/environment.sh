@@ -20,3 +20,8 @@ export SUBDIRS=libflatsurf:pyflatsurf:flatsurf-polygon
 if [[ "$target" == "release" ]]; then
   export CONFIGURE_FLAGS=--without-local-libflatsurf
 fi
+
+# Build libflatsurf with the C++20 coroutine engine of the saddle connection search
+if [[ "$target" == "coroutines" ]]; then
+  export CONFIGURE_FLAGS=--enable-coroutines
+fi